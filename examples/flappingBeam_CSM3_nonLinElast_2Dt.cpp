@@ -42,6 +42,9 @@ int main(int argc, char* argv[]){
     // time integration
     real_t timeSpan = 2;
     real_t timeStep = 0.01;
+    bool adaptive = false;
+    real_t minTimeStep = 1e-4;
+    real_t errTol = 1e-3;
     // output
     index_t numPlotPoints = 1000;
 
@@ -52,6 +55,9 @@ int main(int argc, char* argv[]){
     cmd.addInt("d","degelev","Number of degree elevation application",numDegElev);
     cmd.addReal("t","time","Time span, sec",timeSpan);
     cmd.addReal("s","step","Time step, sec",timeStep);
+    cmd.addSwitch("a","adaptive","Use adaptive time stepping; the time step is the initial one",adaptive);
+    cmd.addReal("m","minstep","Minimal time step for adaptive time stepping, sec",minTimeStep);
+    cmd.addReal("e","errtol","Relative tolerance for the local time error in adaptive time stepping",errTol);
     cmd.addInt("p","points","Number of sampling points to plot to Paraview",numPlotPoints);
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
 
@@ -101,6 +107,8 @@ int main(int argc, char* argv[]){
     gsElTimeIntegrator<real_t> timeSolver(assembler,massAssembler);
     timeSolver.options().setInt("Scheme",time_integration::implicit_nonlinear);
     timeSolver.options().setInt("Verbosity",solver_verbosity::none);
+    timeSolver.options().setReal("MinTimeStep",minTimeStep);
+    timeSolver.options().setReal("ErrRelTol",errTol);
 
     //=============================================//
             // Setting output & auxilary//
@@ -120,6 +128,8 @@ int main(int argc, char* argv[]){
     std::ofstream logFile;
     logFile.open("flappingBeam_CSM3.txt");
     logFile << "# simTime dispAx dispAy compTime numIters\n";
+    // rejected time steps of the adaptive time stepping
+    index_t numRejected = 0;
 
     gsProgressBar bar;
     gsStopwatch iterClock, totalClock;
@@ -155,13 +165,38 @@ int main(int argc, char* argv[]){
         bar.display(simTime/timeSpan);
         iterClock.restart();
 
-        timeSolver.makeTimeStep(timeStep);
+        if (adaptive)
+        {
+            // do not step over the end of the simulation
+            const real_t tStep = math::min(timeStep,timeSpan-simTime);
+            real_t nextTimeStep;
+            const bool accepted = timeSolver.makeAdaptiveTimeStep(tStep,nextTimeStep);
+            compTime += iterClock.stop();
+            if (!accepted)
+            {
+                if (timeSolver.solverStatus() != solver_status::converged && tStep <= minTimeStep)
+                {
+                    gsInfo << "\nNewton's method failed at the minimal time step. Terminated.\n";
+                    break;
+                }
+                // the state is recovered; repeat the step with the proposed size
+                ++numRejected;
+                timeStep = nextTimeStep;
+                continue;
+            }
+            simTime += tStep;
+            timeStep = nextTimeStep;
+        }
+        else
+        {
+            timeSolver.makeTimeStep(timeStep);
+            compTime += iterClock.stop();
+            simTime += timeStep;
+        }
         timeSolver.constructSolution(displacement);
 
         //assembler.constructCauchyStresses(displacement,stresses,stress_components::von_mises);
 
-        compTime += iterClock.stop();
-        simTime += timeStep;
         numTimeStep++;
 
         if (numPlotPoints > 0)
@@ -174,6 +209,8 @@ int main(int argc, char* argv[]){
     //=============================================//
 
     gsInfo << "Simulation time: " + secToHMS(compTime) << " (total time: " + secToHMS(totalClock.stop()) + ")\n";
+    if (adaptive)
+        gsInfo << "Time steps: " << numTimeStep << " accepted, " << numRejected << " rejected.\n";
 
     if (numPlotPoints > 0)
     {
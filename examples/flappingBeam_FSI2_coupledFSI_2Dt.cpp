@@ -11,6 +11,7 @@
 #include <gsElasticity/gsMassAssembler.h>
 #include <gsElasticity/gsALE.h>
 #include <gsElasticity/gsPartitionedFSI.h>
+#include <gsElasticity/gsMonolithicFSI.h>
 #include <gsElasticity/gsWriteParaviewMultiPhysics.h>
 #include <gsElasticity/gsGeoUtils.h>
 
@@ -21,7 +22,7 @@ void writeLog(std::ofstream & ofs, const gsNsAssembler<real_t> & assemblerFlow,
               const gsMultiPatch<> & displacementBeam, const gsMultiPatch<> & geoALE, const gsMultiPatch<> & dispALE,
               real_t simTime, real_t aleTime, real_t flowTime, real_t beamTime,
               index_t couplingIter, index_t flowIter, index_t beamIter,
-              real_t omega, real_t resAbs, real_t resRel)
+              real_t couplingInfo, real_t resAbs, real_t resRel)
 {
     // computing force acting on the surface of the submerged structure
     std::vector<std::pair<index_t, boxSide> > bdrySides;
@@ -48,12 +49,13 @@ void writeLog(std::ofstream & ofs, const gsNsAssembler<real_t> & assemblerFlow,
 
     // print: 1-simTime 2-drag 3-lift 4-pressureDiff 5-dispAx 6-dispAy 7-aleNorm
     //        8-aleTime 9-flowTime 10-beamTime 11-couplingIter 12-flowIter 13-beamIter
-    //        14-omega 15-resAbs 16-resRel
+    //        14-couplingInfo (Aitken's relaxation parameter of the partitioned solver or
+    //        the number of GMRES iterations of the monolithic solver) 15-resAbs 16-resRel
     ofs << simTime << " " << force.at(0) << " " << force.at(1) << " " << presFront.at(0)-presBack.at(0) << " "
         << dispA.at(0) << " " << dispA.at(1) << " " << normL2(geoALE,dispALE) << " "
         << aleTime << " " << flowTime << " " << beamTime << " "
         << couplingIter << " " << flowIter << " " << beamIter << " "
-        << omega << " " << resAbs << " " << resRel << std::endl;
+        << couplingInfo << " " << resAbs << " " << resRel << std::endl;
 }
 
 int main(int argc, char* argv[])
@@ -88,7 +90,10 @@ int main(int argc, char* argv[])
     real_t thetaFluid = 0.5;
     real_t thetaSolid = 1.;
     index_t maxCouplingIter = 10;
+    index_t acceleration = coupling_acceleration::aitken;
     bool imexOrNewton = false;
+    bool monolithic = false;
+    bool jacobi = false;
     bool warmUp = false;
     // output parameters
     index_t numPlotPoints = 0.;
@@ -105,6 +110,9 @@ int main(int argc, char* argv[])
     cmd.addReal("t","time","Time span, sec",timeSpan);
     cmd.addReal("s","step","Time step",timeStep);
     cmd.addInt("i","iter","Number of coupling iterations",maxCouplingIter);
+    cmd.addInt("c","coupling","Acceleration of the coupling iterations: 0 - Aitken, 1 - IQN-ILS, 2 - IQN-IMVJ",acceleration);
+    cmd.addSwitch("j","jacobi","Solve the flow and the beam concurrently in the coupling iterations (Jacobi coupling)",jacobi);
+    cmd.addSwitch("n","monolithic","Solve the coupled problem monolithically by Newton's method (implies the Newton's method for the flow)",monolithic);
     cmd.addSwitch("w","warmup","Use large time steps during the first 2 seconds",warmUp);
     cmd.addInt("p","points","Number of points to plot to Paraview",numPlotPoints);
     cmd.addInt("v","verbosity","Amount of info printed to the prompt: 0 - none, 1 - crucial, 2 - all",verbosity);
@@ -227,7 +235,7 @@ int main(int argc, char* argv[])
     gsMassAssembler<real_t> nsMassAssembler(geoFlow,basisVelocity,bcInfoFlow,gZero);
     nsMassAssembler.options().setReal("Density",densityFluid);
     gsNsTimeIntegrator<real_t> nsTimeSolver(nsAssembler,nsMassAssembler,&velALE,&interfaceALE2Flow);
-    nsTimeSolver.options().setInt("Scheme",imexOrNewton ? time_integration::implicit_nonlinear : time_integration::implicit_linear);
+    nsTimeSolver.options().setInt("Scheme",(imexOrNewton || monolithic) ? time_integration::implicit_nonlinear : time_integration::implicit_linear);
     nsTimeSolver.options().setReal("Theta",thetaFluid);
     nsTimeSolver.options().setSwitch("ALE",true);
     gsInfo << "Initialized Navier-Stokes system with " << nsAssembler.numDofs() << " dofs.\n";
@@ -249,14 +257,31 @@ int main(int argc, char* argv[])
     moduleALE.options().setReal("PoissonsRatio",meshPR);
     moduleALE.options().setSwitch("Check",false);
     gsInfo << "Initialized mesh deformation system with " << moduleALE.numDofs() << " dofs.\n";
-    // FSI coupling module
-    gsPartitionedFSI<real_t> moduleFSI(nsTimeSolver,velFlow, presFlow,
-                                       elTimeSolver,dispBeam,
-                                       moduleALE,dispALE,velALE);
-    moduleFSI.options().setInt("MaxIter",maxCouplingIter);
-    moduleFSI.options().setReal("AbsTol",1e-10);
-    moduleFSI.options().setReal("RelTol",1e-6);
-    moduleFSI.options().setInt("Verbosity",verbosity);
+    // FSI coupling module: partitioned or monolithic with the same component solvers
+    memory::unique_ptr<gsPartitionedFSI<real_t> > moduleFSI;
+    memory::unique_ptr<gsMonolithicFSI<real_t> > monolithicFSI;
+    if (monolithic)
+    {
+        monolithicFSI.reset(new gsMonolithicFSI<real_t>(nsTimeSolver,velFlow, presFlow,
+                                                        elTimeSolver,dispBeam,
+                                                        moduleALE,dispALE,velALE));
+        monolithicFSI->options().setInt("MaxIter",maxCouplingIter);
+        monolithicFSI->options().setReal("AbsTol",1e-10);
+        monolithicFSI->options().setReal("RelTol",1e-6);
+        monolithicFSI->options().setInt("Verbosity",verbosity);
+    }
+    else
+    {
+        moduleFSI.reset(new gsPartitionedFSI<real_t>(nsTimeSolver,velFlow, presFlow,
+                                                     elTimeSolver,dispBeam,
+                                                     moduleALE,dispALE,velALE));
+        moduleFSI->options().setInt("MaxIter",maxCouplingIter);
+        moduleFSI->options().setInt("Acceleration",acceleration);
+        moduleFSI->options().setSwitch("Jacobi",jacobi);
+        moduleFSI->options().setReal("AbsTol",1e-10);
+        moduleFSI->options().setReal("RelTol",1e-6);
+        moduleFSI->options().setInt("Verbosity",verbosity);
+    }
 
     //=============================================//
              // Setting output and auxilary //
@@ -288,7 +313,7 @@ int main(int argc, char* argv[])
     std::ofstream logFile;
     logFile.open("flappingBeam_FSI2.txt");
     logFile << "# simTime drag lift presDiff dispAx dispAy aleNorm aleTime flowTime"
-            << " beamTime couplingIter flowIter beamIter omega resAbs resRel\n";
+            << " beamTime couplingIter flowIter beamIter " << (monolithic ? "linIter" : "omega") << " resAbs resRel\n";
 
     gsProgressBar bar;
     gsStopwatch totalClock, iterClock;
@@ -347,7 +372,7 @@ int main(int argc, char* argv[])
         if (simTime > 7.)
             moduleALE.options().setSwitch("Check",true);
 
-        if (!moduleFSI.makeTimeStep(tStep))
+        if (!(monolithic ? monolithicFSI->makeTimeStep(tStep) : moduleFSI->makeTimeStep(tStep)))
         {
             gsInfo << "Invalid ALE mapping. Terminated.\n";
             break;
@@ -355,9 +380,9 @@ int main(int argc, char* argv[])
 
         // Iteration end
         simTime += tStep;
-        timeALE += moduleFSI.timeALE();
-        timeBeam += moduleFSI.timeEL();
-        timeFlow += moduleFSI.timeNS();
+        timeALE += monolithic ? monolithicFSI->timeALE() : moduleFSI->timeALE();
+        timeBeam += monolithic ? monolithicFSI->timeEL() : moduleFSI->timeEL();
+        timeFlow += monolithic ? monolithicFSI->timeNS() + monolithicFSI->timeLinear() : moduleFSI->timeNS();
         numTimeStep++;
 
         if (numPlotPoints > 0)
@@ -368,9 +393,12 @@ int main(int argc, char* argv[])
             plotDeformation(geoALE,dispALE,"flappingBeam_FSI2_ALE",collectionALE,numTimeStep);
         }
         writeLog(logFile,nsAssembler,velFlow,presFlow,dispBeam,geoALE,dispALE,
-                 simTime,timeALE,timeFlow,timeBeam, moduleFSI.numberIterations(),
+                 simTime,timeALE,timeFlow,timeBeam,
+                 monolithic ? monolithicFSI->numberIterations() : moduleFSI->numberIterations(),
                  nsTimeSolver.numberIterations(),elTimeSolver.numberIterations(),
-                 moduleFSI.aitkenOmega(),moduleFSI.residualNormAbs(),moduleFSI.residualNormRel());
+                 monolithic ? monolithicFSI->numberLinearIterations() : moduleFSI->aitkenOmega(),
+                 monolithic ? monolithicFSI->residualNormAbs() : moduleFSI->residualNormAbs(),
+                 monolithic ? monolithicFSI->residualNormRel() : moduleFSI->residualNormRel());
     }
 
     //=============================================//
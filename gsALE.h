@@ -18,6 +18,7 @@
 #include <gsCore/gsMultiPatch.h>
 #include <gsElasticity/gsIterative.h>
 #include <gsElasticity/gsBaseAssembler.h>
+#include <gsElasticity/gsLinearSolverCache.h>
 
 namespace gismo
 {
@@ -49,6 +50,13 @@ public:
     /// update mesh to comply with the current displacement field
     index_t updateMesh();
 
+    /// solve the system of the linear methods (HE, LE, BHE) with the persistent factorization;
+    /// each column of the rhs is a separate right-hand side (for HE and BHE, one per displacement component)
+    gsMatrix<T> solve(const gsMatrix<T> & rhs);
+
+    /// access the linear solver, e.g. to check how many factorizations were performed
+    const gsLinearSolverCache<T> & linearSolver() const { return linSolver; }
+
     /// save module state
     void saveState();
 
@@ -83,6 +91,8 @@ protected:
     typename gsBaseAssembler<T>::uPtr assembler;
     /// nonlinear solver
     typename gsIterative<T>::uPtr solverNL;
+    /// linear solver; for HE, LE and BHE, the matrix is factorized once since only the Dirichlet DoFs change
+    gsLinearSolverCache<T> linSolver;
     /// current ALE displacement field
     gsMultiPatch<T> ALEdisp;
     /// initialization flag
@@ -32,6 +32,7 @@ gsALE<T>::gsALE(gsMultiPatch<T> & geometry, const gsMultiPatch<T> & displacement
       m_interface(interfaceS2M),
       methodALE(method),
       m_options(defaultOptions()),
+      linSolver(linear_solver::LDLT),
       initialized(false),
       hasSavedState(false)
 {
@@ -111,7 +112,10 @@ void gsALE<T>::initialize()
     if (methodALE == ale_method::LE || methodALE == ale_method::ILE || methodALE == ale_method::TINE || methodALE == ale_method::TINE_StVK)
         assembler->options().setReal("PoissonsRatio",m_options.getReal("PoissonsRatio"));
     if (methodALE == ale_method::LE || methodALE == ale_method::HE || methodALE == ale_method::BHE)
+    {
         assembler->assemble(true);
+        linSolver.factorize(assembler->matrix());
+    }
     if (methodALE == ale_method::TINE || methodALE == ale_method::TINE_StVK)
         solverNL->options().setInt("MaxIters",m_options.getInt("NumIter"));
 
@@ -138,6 +142,18 @@ index_t gsALE<T>::updateMesh()
     }
 }
 
+template <class T>
+gsMatrix<T> gsALE<T>::solve(const gsMatrix<T> & rhs)
+{
+    GISMO_ENSURE(methodALE == ale_method::HE || methodALE == ale_method::LE || methodALE == ale_method::BHE,
+                 "Only linear ALE methods have a persistent factorization");
+    if (!initialized)
+        initialize();
+    GISMO_ENSURE(rhs.rows() == assembler->numDofs(), "Wrong size of the rhs! Expected " +
+                 util::to_string(assembler->numDofs()) + " rows, got " + util::to_string(rhs.rows()) + ".");
+    return linSolver.solve(rhs);
+}
+
 template <class T>
 index_t gsALE<T>::linearMethod()
 {
@@ -148,14 +164,7 @@ index_t gsALE<T>::linearMethod()
                                 disp.patch(m_interface.sidesA[i].patch).boundary(m_interface.sidesA[i].side())->coefs(),
                                 methodALE == ale_method::LE ? false : true);
     assembler->eliminateFixedDofs();
-
-#ifdef GISMO_WITH_PARDISO
-    gsSparseSolver<>::PardisoLDLT solver(assembler->matrix());
-    gsMatrix<> solVector = solver.solve(assembler->rhs());
-#else
-    gsSparseSolver<>::SimplicialLDLT solver(assembler->matrix());
-    gsMatrix<> solVector = solver.solve(assembler->rhs());
-#endif
+    gsMatrix<T> solVector = solve(assembler->rhs());
 
     assembler->constructSolution(solVector,assembler->allFixedDofs(),ALEdisp);
     if (m_options.getSwitch("Check"))
@@ -174,14 +183,9 @@ index_t gsALE<T>::linearIncrementalMethod()
                                 ALEdisp.patch(m_interface.sidesB[i].patch).boundary(m_interface.sidesB[i].side())->coefs(),
                                 methodALE == ale_method::ILE ? false : true);
     assembler->assemble();
-
-#ifdef GISMO_WITH_PARDISO
-    gsSparseSolver<>::PardisoLDLT solver(assembler->matrix());
-    gsMatrix<> solVector = solver.solve(assembler->rhs());
-#else
-    gsSparseSolver<>::SimplicialLDLT solver(assembler->matrix());
-    gsMatrix<> solVector = solver.solve(assembler->rhs());
-#endif
+    // the matrix changes with the geometry, but its sparsity pattern does not
+    linSolver.factorize(assembler->matrix());
+    gsMatrix<T> solVector = linSolver.solve(assembler->rhs());
 
     gsMultiPatch<T> ALEupdate;
     assembler->constructSolution(solVector,assembler->allFixedDofs(),ALEupdate);
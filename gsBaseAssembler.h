@@ -29,18 +29,43 @@ public:
     typedef memory::shared_ptr<gsBaseAssembler> Ptr;
     typedef memory::unique_ptr<gsBaseAssembler> uPtr;
 
+    gsBaseAssembler() : eliminationMatrixValid(false) {}
+
+    /// @brief Returns the list of default options for assembly
+    static gsOptionList defaultOptions();
+
     /// Assembles the tangential linear system for Newton's method given the current solution
     /// in the form of free and fixed/Dirichelt degrees of freedom.
     /// Checks if the current solution is valid (Newton's solver can exit safely if invalid).
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDDoFs) = 0;
 
+    /// Assembles only the residual (the RHS) for Newton's method given the current solution;
+    /// the matrix is kept from the last full assembly. Used by the modified Newton's method.
+    /// Falls back to the full assembly if an assembler does not provide a cheaper residual evaluation.
+    virtual bool assembleResidual(const gsMatrix<T> & solutionVector,
+                                  const std::vector<gsMatrix<T> > & fixedDDoFs)
+    { return assemble(solutionVector,fixedDDoFs); }
+
+    /// Returns true if assembleResidual() leaves the matrix untouched; otherwise, the matrix is overwritten
+    /// by the fallback to the full assembly
+    virtual bool hasResidualAssembly() const { return false; }
+
     /// assembly procedure for linear problems
     virtual void assemble(bool saveEliminationMatrix = false) {};
 
     /// Returns number of free degrees of freedom
     virtual int numDofs() const { return gsAssembler<T>::numDofs(); }
 
+    /// Returns the numbers of free degrees of freedom of all unknowns (blocks of the system) in the order of the solution vector
+    virtual std::vector<index_t> freeBlockSizes() const
+    {
+        std::vector<index_t> sizes;
+        for (size_t d = 0; d < m_bases.size(); ++d)
+            sizes.push_back(m_system.colMapper(d).freeSize());
+        return sizes;
+    }
+
     /// Constructs solution as a gsMultiPatch object from the solution vector and fixed DoFs
     virtual void constructSolution(const gsMatrix<T> & solVector,
                                    const std::vector<gsMatrix<T> > & fixedDDofs,
@@ -75,22 +100,183 @@ public:
     /// @brief Eliminates new Dirichelt degrees of fredom
     virtual void eliminateFixedDofs();
 
+    /// @brief Returns true if an elimination matrix matching the current system is available (see assemble(true)),
+    /// so that a change of Dirichlet DoFs only costs eliminateFixedDofs() instead of a new assembly.
+    /// Any later assembly of the matrix without saving the elimination matrix invalidates it.
+    /// Note that the rhs saved by assemble(true) already contains the contribution of the fixed DoFs set at that moment;
+    /// homogenize them before assemble(true) if eliminateFixedDofs() is used afterwards
+    bool hasEliminationMatrix() const
+    {
+        return eliminationMatrixValid && eliminationMatrix.rows() == numDofs() &&
+               eliminationMatrix.cols() == numFixedDofs() && rhsWithZeroDDofs.rows() == numDofs();
+    }
+
+    /// @brief Returns the elimination matrix of the last assembly with a saved elimination matrix, i.e.
+    /// the derivative of the rhs w.r.t. the fixed DoFs with the opposite sign, see eliminateFixedDofs()
+    const gsSparseMatrix<T> & getEliminationMatrix() const { return eliminationMatrix; }
+
+    /** @brief Positions of the DoFs on a given side of a given patch in the solution vector and in the vector of fixed DoFs.
+     *
+     * The DoFs of the first *numUnknowns* unknowns are considered; each unknown corresponds to a column of the resulting matrices
+     * and the rows follow the numbering of basis().boundary(side). *freeIndices* contains the positions of free DoFs
+     * in the solution vector and -1 for fixed DoFs; *fixedIndices* contains the positions of fixed DoFs in the concatenation
+     * of all fixed DoFs (as used by eliminateFixedDofs()) and -1 for free DoFs.
+     */
+    void sideDofIndices(index_t patch, boxSide side, short_t numUnknowns,
+                        gsMatrix<index_t> & freeIndices, gsMatrix<index_t> & fixedIndices) const;
+
     //virtual void modifyDirichletDofs(size_t patch, boxSide side, const gsMatrix<T> & ddofs);
 
+    //--------------------- SCHUR COMPLEMENT OPERATORS ----------------------------------//
+
+    /** @brief Assembles operators on the pressure space used by Schur complement preconditioners
+     * for mixed formulations at the current solution: the pressure mass matrix and, if supported, the pressure Laplacian
+     * and the pressure convection-diffusion operator (PCD). The pressure is the last block of the system.
+     * Returns the effective viscosity (or shear modulus) such that the Schur complement of the velocity (displacement) block
+     * is close to the pressure mass matrix divided by it; returns 0 if there is no pressure unknown.
+     */
+    virtual T assembleSchurOperators(const gsMatrix<T> & solutionVector,
+                                     const std::vector<gsMatrix<T> > & fixedDDoFs,
+                                     gsSparseMatrix<T> & mass,
+                                     gsSparseMatrix<T> & laplacian,
+                                     gsSparseMatrix<T> & convDiff) { return 0.; }
+
+    //--------------------- MATRIX-FREE TANGENT ----------------------------------//
+
+    /// Returns true if the assembler can apply the tangential matrix without assembling it, see applyTangent()
+    virtual bool hasMatrixFreeTangent() const { return false; }
+
+    /// Matrix-free product of the tangential matrix at a given solution with vectors of free DoFs: result = K(u)*v;
+    /// the system matrix and the rhs stay untouched
+    virtual void applyTangent(const gsMatrix<T> & solutionVector,
+                              const std::vector<gsMatrix<T> > & fixedDDoFs,
+                              const gsMatrix<T> & v, gsMatrix<T> & result)
+    { GISMO_NO_IMPLEMENTATION }
+
+    /// Diagonal of the tangential matrix at a given solution computed without assembling the matrix,
+    /// e.g. for a Jacobi preconditioner of applyTangent()
+    virtual void tangentDiagonal(const gsMatrix<T> & solutionVector,
+                                 const std::vector<gsMatrix<T> > & fixedDDoFs,
+                                 gsMatrix<T> & result)
+    { GISMO_NO_IMPLEMENTATION }
+
     //--------------------- OTHER ----------------------------------//
 
     virtual void setRHS(const gsMatrix<T> & rhs) {m_system.rhs() = rhs;}
 
-    virtual void setMatrix(const gsSparseMatrix<T> & matrix) {m_system.matrix() = matrix;}
+    virtual void setMatrix(const gsSparseMatrix<T> & matrix) {m_system.matrix() = matrix; eliminationMatrixValid = false;}
 
 protected:
+    /// assembles the pressure operators with gsVisitorPressureOperators; laplacian and convDiff are optional
+    void assemblePressureOperators(gsSparseMatrix<T> & mass,
+                                   gsSparseMatrix<T> * laplacian = nullptr,
+                                   gsSparseMatrix<T> * convDiff = nullptr,
+                                   const gsMultiPatch<T> * velocity = nullptr,
+                                   T viscosity = 0., T density = 1.);
+
+    /// forms the elimination matrix from the entries collected by a visitor (duplicates are summed up)
+    /// and saves the rhs for homogeneous Dirichlet DoFs; must be called right after the assembly
+    void setEliminationMatrix(const gsSparseEntries<T> & elimEntries)
+    {
+        eliminationMatrix.resize(numDofs(),numFixedDofs());
+        eliminationMatrix.setFrom(elimEntries);
+        eliminationMatrix.makeCompressed();
+        rhsWithZeroDDofs = m_system.rhs();
+        eliminationMatrixValid = true;
+    }
+
+    using gsAssembler<T>::push;
+
+    /** @brief Element loop over all patches for a given visitor; replaces the serial loop of gsAssembler.
+     *
+     * Elements of a patch are processed in batches of *ParallelBatch* elements per thread.
+     * Every element of a batch has its own copy of the visitor, so that evaluate() and assemble()
+     * run concurrently without shared state. The element contributions are then written to the global system
+     * by a single thread in the order of the serial element loop. Hence, the scatter needs no locks,
+     * and the assembled system does not depend on the number of threads.
+     * Works with any visitor providing initialize/evaluate/assemble/localToGlobal.
+     *
+     * The parallel loop is off by default (*ParallelBatch* = 0). Before switching it on, make sure that everything
+     * evaluated inside evaluate() and assemble() is safe to call from several threads at once: in particular,
+     * user-provided load and coefficient functions (body forces, fiber directions, etc.) must not modify shared state,
+     * e.g. caches or counters, during evaluation.
+     */
+    template <class ElementVisitor>
+    void push(const ElementVisitor & visitor)
+    {
+#ifdef _OPENMP
+        const index_t batch = m_options.askInt("ParallelBatch",0);
+        const int nt = omp_get_max_threads();
+        if (batch > 0 && nt > 1)
+        {
+            for (size_t np = 0; np < m_pde_ptr->domain().nPatches(); ++np)
+                pushPatch<ElementVisitor>(visitor,np,nt,batch);
+            return;
+        }
+#endif
+        gsAssembler<T>::template push<ElementVisitor>(visitor);
+    }
+
+#ifdef _OPENMP
+    /// parallel element loop over one patch, see push()
+    template <class ElementVisitor>
+    void pushPatch(const ElementVisitor & visitor, index_t patchIndex, int nt, index_t batch)
+    {
+        const gsBasisRefs<T> bases(m_bases,patchIndex);
+        const gsGeometry<T> & patch = m_pde_ptr->patches()[patchIndex];
+        const index_t numElements = bases[0].numElements();
+        const index_t batchSize = std::min<index_t>(nt*batch,numElements);
+        if (batchSize == 0)
+            return;
+
+        // one visitor per element of a batch; the quadrature rule is the same for all of them
+        gsQuadRule<T> quRule;
+        std::vector<ElementVisitor> visitors(batchSize,visitor);
+        for (index_t i = 0; i < batchSize; ++i)
+            visitors[i].initialize(bases,patchIndex,m_options,quRule);
+
+#pragma omp parallel num_threads(nt)
+        {
+            const int tid = omp_get_thread_num();
+            gsMatrix<T> quNodes;
+            gsVector<T> quWeights;
+            // each thread visits elements tid, tid+nt, tid+2*nt, ...
+            typename gsBasis<T>::domainIter domIt = bases[0].makeDomainIterator(boundary::none);
+            domIt->next(tid);
+            index_t element = tid;
+
+            for (index_t start = 0; start < numElements; start += batchSize)
+            {
+                for (; domIt->good() && element < start + batchSize; element += nt, domIt->next(nt))
+                {
+                    ElementVisitor & localVisitor = visitors[element-start];
+                    quRule.mapTo(domIt->lowerCorner(),domIt->upperCorner(),quNodes,quWeights);
+                    localVisitor.evaluate(bases,patch,quNodes);
+                    localVisitor.assemble(*domIt,quWeights);
+                }
+#pragma omp barrier
+#pragma omp single
+                {
+                    // deterministic scatter in the order of the serial element loop
+                    const index_t batchEnd = std::min(batchSize,numElements-start);
+                    for (index_t i = 0; i < batchEnd; ++i)
+                        visitors[i].localToGlobal(patchIndex,m_ddof,m_system);
+                } // implicit barrier: visitors are not reused before the scatter is finished
+            }
+        }
+    }
+#endif
+
     using gsAssembler<T>::m_pde_ptr;
     using gsAssembler<T>::m_bases;
     using gsAssembler<T>::m_system;
     using gsAssembler<T>::m_ddof;
+    using gsAssembler<T>::m_options;
 
     gsSparseMatrix<T> eliminationMatrix;
     gsMatrix<T> rhsWithZeroDDofs;
+    /// true if the elimination matrix belongs to the current system matrix; reset by every matrix assembly
+    bool eliminationMatrixValid;
 };
 
 } // namespace ends
@@ -16,9 +16,51 @@
 
 #include <gsElasticity/gsBaseAssembler.h>
 
+#include <gsElasticity/gsVisitorPressureOperators.h>
+
 namespace gismo
 {
 
+template <class T>
+gsOptionList gsBaseAssembler<T>::defaultOptions()
+{
+    gsOptionList opt = gsAssembler<T>::defaultOptions();
+    opt.addInt("ParallelBatch","Number of elements per thread assembled concurrently before they are written "
+                               "to the global system; 0 for the serial element loop. The load functions of the PDE "
+                               "must be thread-safe if set to a positive value",0);
+    return opt;
+}
+
+template <class T>
+void gsBaseAssembler<T>::assemblePressureOperators(gsSparseMatrix<T> & mass,
+                                                   gsSparseMatrix<T> * laplacian,
+                                                   gsSparseMatrix<T> * convDiff,
+                                                   const gsMultiPatch<T> * velocity,
+                                                   T viscosity, T density)
+{
+    const index_t numPres = m_system.colMapper(m_bases.size()-1).freeSize();
+    gsSparseEntries<T> massEntries, laplacianEntries, convDiffEntries;
+    gsVisitorPressureOperators<T> visitor(massEntries,laplacian ? &laplacianEntries : nullptr,
+                                          convDiff ? &convDiffEntries : nullptr,velocity,viscosity,density);
+    push<gsVisitorPressureOperators<T> >(visitor);
+
+    mass.resize(numPres,numPres);
+    mass.setFrom(massEntries);
+    mass.makeCompressed();
+    if (laplacian)
+    {
+        laplacian->resize(numPres,numPres);
+        laplacian->setFrom(laplacianEntries);
+        laplacian->makeCompressed();
+    }
+    if (convDiff)
+    {
+        convDiff->resize(numPres,numPres);
+        convDiff->setFrom(convDiffEntries);
+        convDiff->makeCompressed();
+    }
+}
+
 template <class T>
 void gsBaseAssembler<T>::constructSolution(const gsMatrix<T> & solVector,
                                            const std::vector<gsMatrix<T> > & fixedDoFs,
@@ -138,6 +180,34 @@ void gsBaseAssembler<T>::getFixedDofs(index_t patch, boxSide side, gsMatrix<T> &
 
 }
 
+template <class T>
+void gsBaseAssembler<T>::sideDofIndices(index_t patch, boxSide side, short_t numUnknowns,
+                                        gsMatrix<index_t> & freeIndices, gsMatrix<index_t> & fixedIndices) const
+{
+    GISMO_ENSURE(numUnknowns <= (short_t)m_ddof.size(),"Too many unknowns requested: " + util::to_string(numUnknowns));
+    gsMatrix<index_t> localBIndices = m_bases[0][patch].boundary(side);
+    freeIndices.setConstant(localBIndices.rows(),numUnknowns,-1);
+    fixedIndices.setConstant(localBIndices.rows(),numUnknowns,-1);
+    std::vector<index_t> blockSizes = freeBlockSizes();
+    // positions of the first DoF of the current unknown in the solution vector and in the vector of fixed DoFs
+    index_t freeShift = 0;
+    index_t fixedShift = 0;
+    gsMatrix<index_t> globalIndices;
+    for (short_t d = 0; d < numUnknowns; ++d)
+    {
+        m_system.mapColIndices(localBIndices, patch, globalIndices, d);
+        for (index_t i = 0; i < globalIndices.rows(); ++i)
+        {
+            if (globalIndices(i,0) < m_system.colMapper(d).freeSize())
+                freeIndices(i,d) = freeShift + globalIndices(i,0);
+            else
+                fixedIndices(i,d) = fixedShift + m_system.colMapper(d).global_to_bindex(globalIndices(i,0));
+        }
+        freeShift += blockSizes[d];
+        fixedShift += m_ddof[d].rows();
+    }
+}
+
 template <class T>
 index_t gsBaseAssembler<T>::numFixedDofs() const
 {
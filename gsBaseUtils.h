@@ -49,6 +49,17 @@ struct ns_assembly
     };
 };
 
+/// @brief Specifies the acceleration of the coupling iterations in partitioned fluid-structure interaction
+struct coupling_acceleration
+{
+    enum method
+    {
+        aitken = 0,     /// Aitken's dynamic relaxation with a scalar relaxation parameter
+        IQN_ILS = 1,    /// interface quasi-Newton: inverse Jacobian from least squares on the residual history
+        IQN_IMVJ = 2    /// interface quasi-Newton: multi-vector inverse Jacobian carried over between time steps
+    };
+};
+
 /// @brief Specifies the time integration scheme, see Wriggers, Nonlinear FEM, p. 205
 struct time_integration
 {
@@ -69,10 +80,61 @@ struct linear_solver
         LU = 0,              /// LU decomposition: direct, no matrix requirements, robust but a bit slow, Eigen and Pardiso available
         LDLT = 1,            /// Cholesky decomposition pivoting: direct, simmetric positive or negative semidefinite, rather fast, Eigen and Pardiso available
         CGDiagonal = 2,      /// Conjugate gradient solver with diagonal (a.k.a. Jacobi) preconditioning: iterative(!), simmetric, Eigen only
-        BiCGSTABDiagonal = 3 /// Bi-conjugate gradient stabilized solver with diagonal (a.k.a. Jacobi) preconditioning: iterative(!), no matrix requirements, Eigen only
+        BiCGSTABDiagonal = 3,/// Bi-conjugate gradient stabilized solver with diagonal (a.k.a. Jacobi) preconditioning: iterative(!), no matrix requirements, Eigen only
+        CG = 4,              /// Preconditioned conjugate gradient method: iterative(!), symmetric positive definite, see linear_precond
+        MINRES = 5,          /// Preconditioned minimal residual method: iterative(!), symmetric (also indefinite), needs an SPD preconditioner
+        GMRES = 6            /// Preconditioned generalized minimal residual method: iterative(!), no matrix requirements
+    };
+};
+
+/// @brief Specifies the preconditioner for the Krylov solvers linear_solver::CG, MINRES and GMRES
+struct linear_precond
+{
+    enum precond
+    {
+        none = 0,           /// no preconditioning
+        jacobi = 1,         /// diagonal scaling
+        ILUT = 2,           /// incomplete LU factorization with thresholding: general matrices
+        IC0 = 3,            /// incomplete Cholesky factorization: symmetric positive definite matrices
+        block_jacobi = 4,   /// exact solves with diagonal blocks, e.g. one block per displacement component
+        AMG = 5,            /// smoothed aggregation algebraic multigrid, one V-cycle
+        block_triangular = 6/// block upper triangular preconditioner for saddle-point systems [A B1; B2 C], see schur_approx
     };
 };
 
+/// @brief Specifies the Schur complement approximation of the block-triangular saddle-point preconditioner
+struct schur_approx
+{
+    enum approx
+    {
+        mass = 0,   /// scaled pressure mass matrix: Stokes and (near-)incompressible elasticity
+        PCD = 1,    /// pressure convection-diffusion: Oseen and Newton linearizations of Navier-Stokes
+        LSC = 2     /// least-squares commutator: purely algebraic, Navier-Stokes
+    };
+};
+
+
+/// @brief Specifies how often Newton's method assembles and factorizes the Jacobian matrix
+struct jacobian_update
+{
+    enum update
+    {
+        always = 0,     /// full Newton's method: the Jacobian is updated at every iteration
+        every_k = 1,    /// modified Newton's method: the Jacobian is updated every k iterations
+        stagnation = 2  /// modified Newton's method: the Jacobian is updated when the residual stagnates
+    };
+};
+
+/// @brief Specifies the step length control of Newton's method
+struct line_search
+{
+    enum type
+    {
+        none = 0,           /// always take the full Newton step
+        backtracking = 1,   /// Armijo backtracking on the residual norm
+        secant = 2          /// secant root search of the directional derivative of the residual, du*r(u+s*du) = 0
+    };
+};
 
 /// @brief Specifies the verbosity of the iterative solver
 struct solver_verbosity
@@ -122,6 +184,27 @@ struct stress_components
     };
 };
 
+/// @brief Specifies how gsWriteParaviewMultiPhysics stores the data arrays of VTK XML files
+struct paraview_format
+{
+    enum format
+    {
+        ascii = 0,      /// inline text: human-readable, but slow to write and large
+        binary = 1,     /// raw binary data appended to the end of the file
+        compressed = 2  /// zlib-compressed binary data appended to the end of the file; falls back to binary without zlib
+    };
+};
+
+/// @brief Specifies the floating point type of the data arrays written by gsWriteParaviewMultiPhysics
+struct paraview_precision
+{
+    enum precision
+    {
+        float32 = 0,    /// single precision: usually sufficient for visualization, half the size
+        float64 = 1     /// double precision: for post-processing which needs the full accuracy
+    };
+};
+
 /// @brief Specifies the material law to use
 struct material_law
 {
@@ -218,6 +301,19 @@ protected:
     index_t m_width;
 };
 
+/// @brief Step size controller for adaptive time integration; returns a factor for the next time step.
+/// *error* is a scaled error estimate (the step is acceptable if error <= 1) which behaves like dt^order;
+/// the factor is further limited if Newton's method needed more than *targetIters* iterations
+template <class T>
+T timeStepFactor(T error, index_t order, index_t numIters, index_t targetIters,
+                 T safety = 0.9, T minFactor = 0.2, T maxFactor = 2.)
+{
+    T factor = error > 0 ? safety*std::pow(1/error,T(1)/order) : maxFactor;
+    if (targetIters > 0 && numIters > targetIters)
+        factor = std::min(factor,T(targetIters)/numIters);
+    return std::max(minFactor,std::min(factor,maxFactor));
+}
+
 template <class T>
 std::string secToHMS(T sec)
 {
@@ -79,26 +79,18 @@ template<class T>
 void gsBiharmonicAssembler<T>::assemble(bool saveEliminationMatrix)
 {
     m_system.matrix().setZero();
+    Base::eliminationMatrixValid = false;
     reserve();
     m_system.rhs().setZero(Base::numDofs(),m_pde_ptr->numRhs());
 
-    if (saveEliminationMatrix)
-    {
-        eliminationMatrix.resize(Base::numDofs(),Base::numFixedDofs());
-        eliminationMatrix.setZero();
-        eliminationMatrix.reservePerColumn(m_system.numColNz(m_bases[0],m_options));
-    }
-
-    gsVisitorBiharmonic<T> visitor(*m_pde_ptr, saveEliminationMatrix ? &eliminationMatrix : nullptr);
+    gsSparseEntries<T> elimEntries;
+    gsVisitorBiharmonic<T> visitor(*m_pde_ptr, saveEliminationMatrix ? &elimEntries : nullptr);
     Base::template push<gsVisitorBiharmonic<T> >(visitor);
 
     m_system.matrix().makeCompressed();
 
     if (saveEliminationMatrix)
-    {
-        Base::rhsWithZeroDDofs = m_system.rhs();
-        eliminationMatrix.makeCompressed();
-    }
+        Base::setEliminationMatrix(elimEntries);
 }
 
 //--------------------- SOLUTION CONSTRUCTION ----------------------------------//
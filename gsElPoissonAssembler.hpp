@@ -59,26 +59,18 @@ template<class T>
 void gsElPoissonAssembler<T>::assemble(bool saveEliminationMatrix)
 {
     m_system.matrix().setZero();
+    Base::eliminationMatrixValid = false;
     m_system.reserve(m_bases[0], m_options, m_pde_ptr->numRhs());
     m_system.rhs().setZero(Base::numDofs(),m_pde_ptr->numRhs());
 
-    if (saveEliminationMatrix)
-    {
-        eliminationMatrix.resize(Base::numDofs(),Base::numFixedDofs());
-        eliminationMatrix.setZero();
-        eliminationMatrix.reservePerColumn(m_system.numColNz(m_bases[0],m_options));
-    }
-
-    gsVisitorElPoisson<T> visitor(*m_pde_ptr, saveEliminationMatrix ? &eliminationMatrix : nullptr);
+    gsSparseEntries<T> elimEntries;
+    gsVisitorElPoisson<T> visitor(*m_pde_ptr, saveEliminationMatrix ? &elimEntries : nullptr);
     Base::template push<gsVisitorElPoisson<T> >(visitor);
 
     m_system.matrix().makeCompressed();
 
     if (saveEliminationMatrix)
-    {
-        Base::rhsWithZeroDDofs = m_system.rhs();
-        eliminationMatrix.makeCompressed();
-    }
+        Base::setEliminationMatrix(elimEntries);
 }
 
 template <class T>
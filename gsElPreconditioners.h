@@ -0,0 +1,219 @@
+/** @file gsElPreconditioners.h
+
+    @brief Algebraic preconditioners for the Krylov solvers of gsLinearSolverCache.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsSolver/gsLinearOperator.h>
+#include <gsElasticity/gsBaseUtils.h>
+
+namespace gismo
+{
+
+/// @brief Diagonal (a.k.a. Jacobi) preconditioner. Uses the absolute values of the diagonal entries,
+/// so it is symmetric positive definite also for indefinite matrices and can be used with MINRES
+template <class T>
+class gsElJacobiOp : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsElJacobiOp> Ptr;
+    typedef memory::unique_ptr<gsElJacobiOp> uPtr;
+
+    gsElJacobiOp(const gsSparseMatrix<T> & matrix);
+
+    /// constructor with a given diagonal, e.g. of a matrix-free operator
+    gsElJacobiOp(const gsMatrix<T> & diagonal);
+
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const;
+    virtual index_t rows() const { return m_invDiag.rows(); }
+    virtual index_t cols() const { return m_invDiag.rows(); }
+
+protected:
+    gsVector<T> m_invDiag;
+};
+
+/// @brief Incomplete LU factorization with dual thresholding (Eigen::IncompleteLUT), for general matrices
+template <class T>
+class gsElILUTOp : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsElILUTOp> Ptr;
+    typedef memory::unique_ptr<gsElILUTOp> uPtr;
+
+    gsElILUTOp(const gsSparseMatrix<T> & matrix);
+
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const { x = m_ilu.solve(input); }
+    virtual index_t rows() const { return m_size; }
+    virtual index_t cols() const { return m_size; }
+
+protected:
+    Eigen::IncompleteLUT<T,index_t> m_ilu;
+    index_t m_size;
+};
+
+/// @brief Incomplete Cholesky factorization (Eigen::IncompleteCholesky), for symmetric positive definite matrices
+template <class T>
+class gsElICOp : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsElICOp> Ptr;
+    typedef memory::unique_ptr<gsElICOp> uPtr;
+
+    gsElICOp(const gsSparseMatrix<T> & matrix);
+
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const { x = m_ic.solve(input); }
+    virtual index_t rows() const { return m_size; }
+    virtual index_t cols() const { return m_size; }
+
+protected:
+    Eigen::IncompleteCholesky<T,Eigen::Lower,Eigen::AMDOrdering<index_t> > m_ic;
+    index_t m_size;
+};
+
+/** @brief Block-Jacobi preconditioner: exact solves with the diagonal blocks of the matrix.
+ *
+ * The blocks are given by their sizes, e.g. one block per displacement component,
+ * which corresponds to the block structure of the systems assembled by gsElasticity.
+*/
+template <class T>
+class gsElBlockJacobiOp : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsElBlockJacobiOp> Ptr;
+    typedef memory::unique_ptr<gsElBlockJacobiOp> uPtr;
+
+    gsElBlockJacobiOp(const gsSparseMatrix<T> & matrix, const std::vector<index_t> & blockSizes);
+
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const;
+    virtual index_t rows() const { return m_size; }
+    virtual index_t cols() const { return m_size; }
+
+protected:
+    typedef typename gsSparseSolver<T>::LU blockSolver;
+    std::vector<memory::shared_ptr<blockSolver> > m_solvers;
+    std::vector<index_t> m_offsets;
+    index_t m_size;
+};
+
+/** @brief Smoothed aggregation algebraic multigrid, applied as one V-cycle.
+ *
+ * Aggregates are built greedily from the strong connections of the matrix graph, the tentative piecewise constant
+ * prolongation is smoothed by one damped Jacobi step, and coarse matrices are computed by the Galerkin product.
+ * For systems of PDEs, the unknowns are given by their block sizes (e.g. one block per displacement component):
+ * couplings between different unknowns are ignored for aggregation and smoothing, so every aggregate
+ * contains DoFs of a single unknown (unknown-based AMG). Otherwise, aggregates would mix the displacement components
+ * and the constant vector would not approximate the near-nullspace of the elasticity operator.
+ * Damped Jacobi is used as a smoother with the same number of pre- and post-smoothing steps,
+ * so the preconditioner is symmetric for symmetric matrices. The coarsest level is solved directly.
+*/
+template <class T>
+class gsElAMGOp : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsElAMGOp> Ptr;
+    typedef memory::unique_ptr<gsElAMGOp> uPtr;
+
+    /// *blockSizes* are the sizes of the unknown blocks; an empty vector treats the matrix as a scalar problem
+    gsElAMGOp(const gsSparseMatrix<T> & matrix, const std::vector<index_t> & blockSizes = std::vector<index_t>(),
+              index_t smoothingSteps = 2, index_t coarseSize = 500, index_t maxLevels = 10,
+              T strengthThreshold = 0.08, T damping = 2./3);
+
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const;
+    virtual index_t rows() const { return m_matrices.front().rows(); }
+    virtual index_t cols() const { return m_matrices.front().cols(); }
+
+    /// number of levels of the hierarchy including the finest one
+    index_t numLevels() const { return m_matrices.size(); }
+
+protected:
+    /// computes the smoothed prolongation P from a given level to the next coarser level;
+    /// *blocks* is the unknown index of every DoF, *coarseBlocks* returns the unknown index of every aggregate
+    void aggregate(const gsSparseMatrix<T> & A, const std::vector<index_t> & blocks,
+                   gsSparseMatrix<T> & P, std::vector<index_t> & coarseBlocks) const;
+
+    /// V-cycle starting at a given level
+    void cycle(size_t level, const gsMatrix<T> & rhs, gsMatrix<T> & x) const;
+
+protected:
+    std::vector<gsSparseMatrix<T> > m_matrices;
+    std::vector<gsSparseMatrix<T> > m_prolongations;
+    std::vector<gsVector<T> > m_invDiags;
+    typename gsSparseSolver<T>::LU m_coarseSolver;
+    index_t m_smoothingSteps;
+    T m_threshold, m_damping;
+};
+
+/** @brief Block upper triangular preconditioner for saddle-point systems [A B1; B2 C] with the pressure as the last block:
+ *
+ *     P = [A B1; 0 S],   S = C - B2*A^{-1}*B1.
+ *
+ * The velocity (displacement) block A is approximated by a given preconditioner, the Schur complement S by one of
+ * the approximations in schur_approx. The signs of the coupling blocks differ between the formulations
+ * (B2 = B1^T for mixed elasticity, B2 = -B1^T is also possible); they are detected from the matrix.
+ * The preconditioner is not symmetric; use it with GMRES.
+*/
+template <class T>
+class gsElBlockTriangularOp : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsElBlockTriangularOp> Ptr;
+    typedef memory::unique_ptr<gsElBlockTriangularOp> uPtr;
+
+    /// *numPres* is the size of the pressure block, *velocityPrecond* approximates the inverse of A
+    gsElBlockTriangularOp(const gsSparseMatrix<T> & matrix, index_t numPres,
+                          const typename gsLinearOperator<T>::Ptr & velocityPrecond);
+
+    /// S ~ C - mass/coef, where coef is the viscosity (or the shear modulus)
+    void setMassSchur(const gsSparseMatrix<T> & mass, T coef);
+
+    /// S^{-1} ~ -M_p^{-1}*F_p*A_p^{-1} with the pressure mass, Laplacian and convection-diffusion operators
+    void setPCDSchur(const gsSparseMatrix<T> & mass, const gsSparseMatrix<T> & laplacian,
+                     const gsSparseMatrix<T> & convDiff);
+
+    /// S^{-1} ~ -Q^{-1}*(B2*D^{-1}*A*D^{-1}*B1)*Q^{-1} with Q = B2*D^{-1}*B1 and D = diag(A)
+    void setLSCSchur(const gsSparseMatrix<T> & matrix);
+
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const;
+    virtual index_t rows() const { return m_numVel + m_numPres; }
+    virtual index_t cols() const { return m_numVel + m_numPres; }
+
+protected:
+    /// applies the approximate inverse of the Schur complement
+    void applySchurInverse(const gsMatrix<T> & input, gsMatrix<T> & x) const;
+
+protected:
+    typedef typename gsSparseSolver<T>::LU pressureSolver;
+    index_t m_numVel, m_numPres;
+    /// coupling blocks and the pressure-pressure block
+    gsSparseMatrix<T> m_B1, m_B2, m_C;
+    /// +1 if B2*A^{-1}*B1 is positive semidefinite, -1 otherwise
+    T m_sign;
+    typename gsLinearOperator<T>::Ptr m_velocityPrecond;
+    index_t m_approx;
+    /// operators of the Schur complement approximation
+    gsSparseMatrix<T> m_middle;
+    pressureSolver m_solverLeft, m_solverRight;
+};
+
+/// constructs a preconditioner of a given type (see linear_precond, except block_triangular) for a given matrix;
+/// *blockSizes* are used by the block-Jacobi and the AMG preconditioners. Returns an empty pointer for linear_precond::none
+template <class T>
+typename gsLinearOperator<T>::Ptr makeElPreconditioner(index_t precondType, const gsSparseMatrix<T> & matrix,
+                                                       const std::vector<index_t> & blockSizes);
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsElPreconditioners.hpp)
+#endif
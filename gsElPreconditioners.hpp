@@ -0,0 +1,376 @@
+/** @file gsElPreconditioners.hpp
+
+    @brief Algebraic preconditioners for the Krylov solvers of gsLinearSolverCache.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsElPreconditioners.h>
+
+namespace gismo
+{
+
+//--------------------- JACOBI ----------------------------------//
+
+template <class T>
+gsElJacobiOp<T>::gsElJacobiOp(const gsSparseMatrix<T> & matrix)
+{
+    m_invDiag = matrix.diagonal().cwiseAbs();
+    for (index_t i = 0; i < m_invDiag.rows(); ++i)
+        m_invDiag(i) = m_invDiag(i) != 0. ? 1./m_invDiag(i) : 1.;
+}
+
+template <class T>
+gsElJacobiOp<T>::gsElJacobiOp(const gsMatrix<T> & diagonal)
+{
+    m_invDiag = diagonal.col(0).cwiseAbs();
+    for (index_t i = 0; i < m_invDiag.rows(); ++i)
+        m_invDiag(i) = m_invDiag(i) != 0. ? 1./m_invDiag(i) : 1.;
+}
+
+template <class T>
+void gsElJacobiOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+{
+    x = m_invDiag.asDiagonal()*input;
+}
+
+//--------------------- INCOMPLETE FACTORIZATIONS ----------------------------------//
+
+template <class T>
+gsElILUTOp<T>::gsElILUTOp(const gsSparseMatrix<T> & matrix)
+    : m_size(matrix.rows())
+{
+    m_ilu.compute(matrix);
+    GISMO_ENSURE(m_ilu.info() == Eigen::Success,"Incomplete LU factorization failed.");
+}
+
+template <class T>
+gsElICOp<T>::gsElICOp(const gsSparseMatrix<T> & matrix)
+    : m_size(matrix.rows())
+{
+    m_ic.compute(matrix);
+    GISMO_ENSURE(m_ic.info() == Eigen::Success,"Incomplete Cholesky factorization failed. Is the matrix SPD?");
+}
+
+//--------------------- BLOCK JACOBI ----------------------------------//
+
+template <class T>
+gsElBlockJacobiOp<T>::gsElBlockJacobiOp(const gsSparseMatrix<T> & matrix, const std::vector<index_t> & blockSizes)
+    : m_size(matrix.rows())
+{
+    m_offsets.push_back(0);
+    for (size_t b = 0; b < blockSizes.size(); ++b)
+        m_offsets.push_back(m_offsets.back() + blockSizes[b]);
+    GISMO_ENSURE(m_offsets.back() == m_size,"Block sizes do not sum up to the size of the matrix: "
+                 + util::to_string(m_offsets.back()) + " vs " + util::to_string(m_size));
+
+    gsSparseMatrix<T> block;
+    for (size_t b = 0; b < blockSizes.size(); ++b)
+    {
+        block = matrix.block(m_offsets[b],m_offsets[b],blockSizes[b],blockSizes[b]);
+        m_solvers.push_back(memory::make_shared(new blockSolver()));
+        m_solvers.back()->compute(block);
+        GISMO_ENSURE(m_solvers.back()->info() == Eigen::Success,
+                     "Factorization of the diagonal block " + util::to_string(b) + " failed.");
+    }
+}
+
+template <class T>
+void gsElBlockJacobiOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+{
+    x.resize(input.rows(),input.cols());
+    for (size_t b = 0; b < m_solvers.size(); ++b)
+    {
+        const index_t size = m_offsets[b+1] - m_offsets[b];
+        x.middleRows(m_offsets[b],size) = m_solvers[b]->solve(input.middleRows(m_offsets[b],size));
+    }
+}
+
+//--------------------- ALGEBRAIC MULTIGRID ----------------------------------//
+
+template <class T>
+gsElAMGOp<T>::gsElAMGOp(const gsSparseMatrix<T> & matrix, const std::vector<index_t> & blockSizes,
+                        index_t smoothingSteps, index_t coarseSize, index_t maxLevels, T strengthThreshold, T damping)
+    : m_smoothingSteps(smoothingSteps),
+      m_threshold(strengthThreshold),
+      m_damping(damping)
+{
+    // unknown (block) index of every degree of freedom; a single block without block sizes
+    std::vector<index_t> blocks(matrix.rows(),0), coarseBlocks;
+    if (!blockSizes.empty())
+    {
+        index_t offset = 0;
+        for (size_t b = 0; b < blockSizes.size(); ++b)
+        {
+            GISMO_ENSURE(offset + blockSizes[b] <= matrix.rows(),"Block sizes exceed the size of the matrix.");
+            std::fill(blocks.begin()+offset,blocks.begin()+offset+blockSizes[b],index_t(b));
+            offset += blockSizes[b];
+        }
+        GISMO_ENSURE(offset == matrix.rows(),"Block sizes do not sum up to the size of the matrix: "
+                     + util::to_string(offset) + " vs " + util::to_string(matrix.rows()));
+    }
+
+    m_matrices.push_back(matrix);
+    gsSparseMatrix<T> P;
+    while (m_matrices.back().rows() > coarseSize && index_t(m_matrices.size()) < maxLevels)
+    {
+        const gsSparseMatrix<T> & A = m_matrices.back();
+        gsVector<T> invDiag = A.diagonal();
+        for (index_t i = 0; i < invDiag.rows(); ++i)
+            invDiag(i) = invDiag(i) != 0. ? 1./invDiag(i) : 1.;
+        m_invDiags.push_back(invDiag);
+
+        aggregate(A,blocks,P,coarseBlocks);
+        if (P.cols() == 0 || P.cols() >= A.rows()) // no coarsening possible
+        {
+            m_invDiags.pop_back();
+            break;
+        }
+        gsSparseMatrix<T> coarse = P.transpose()*A*P;
+        coarse.makeCompressed();
+        m_prolongations.push_back(P);
+        m_matrices.push_back(coarse);
+        blocks.swap(coarseBlocks);
+    }
+
+    m_coarseSolver.compute(m_matrices.back());
+    GISMO_ENSURE(m_coarseSolver.info() == Eigen::Success,"Factorization of the coarsest AMG level failed.");
+}
+
+template <class T>
+void gsElAMGOp<T>::aggregate(const gsSparseMatrix<T> & A, const std::vector<index_t> & blocks,
+                             gsSparseMatrix<T> & P, std::vector<index_t> & coarseBlocks) const
+{
+    const index_t n = A.rows();
+    // couplings between different unknowns are dropped: aggregation and smoothing act on each unknown separately
+    gsSparseMatrix<T> Afilt = A;
+    for (index_t j = 0; j < n; ++j)
+        for (typename gsSparseMatrix<T>::InnerIterator it(Afilt,j); it; ++it)
+            if (blocks[it.row()] != blocks[it.col()])
+                it.valueRef() = 0.;
+    Afilt.prune(T(0));
+    // symmetric strength of connection |a_ij| > theta*sqrt(|a_ii*a_jj|) computed on the pattern of A+A^T
+    gsSparseMatrix<T> Asym = Afilt.transpose();
+    Asym += Afilt;
+    const gsVector<T> diag = A.diagonal().cwiseAbs();
+    std::vector<std::vector<index_t> > strong(n);
+    for (index_t j = 0; j < n; ++j)
+        for (typename gsSparseMatrix<T>::InnerIterator it(Asym,j); it; ++it)
+            if (it.row() != j && math::abs(it.value())/2 > m_threshold*math::sqrt(diag(it.row())*diag(j)))
+                strong[j].push_back(it.row());
+
+    // greedy aggregation: roots with fully unaggregated neighbourhoods, then attach the rest;
+    // since strong connections never cross unknowns, every aggregate belongs to the unknown of its root
+    std::vector<index_t> agg(n,-1);
+    coarseBlocks.clear();
+    index_t numAgg = 0;
+    for (index_t i = 0; i < n; ++i)
+    {
+        if (agg[i] != -1)
+            continue;
+        bool rootable = true;
+        for (size_t k = 0; k < strong[i].size() && rootable; ++k)
+            rootable = agg[strong[i][k]] == -1;
+        if (!rootable || strong[i].empty())
+            continue;
+        agg[i] = numAgg;
+        for (size_t k = 0; k < strong[i].size(); ++k)
+            agg[strong[i][k]] = numAgg;
+        coarseBlocks.push_back(blocks[i]);
+        ++numAgg;
+    }
+    std::vector<index_t> aggFirstPass(agg);
+    for (index_t i = 0; i < n; ++i)
+        if (agg[i] == -1)
+            for (size_t k = 0; k < strong[i].size(); ++k)
+                if (aggFirstPass[strong[i][k]] != -1)
+                {
+                    agg[i] = aggFirstPass[strong[i][k]];
+                    break;
+                }
+    for (index_t i = 0; i < n; ++i)
+        if (agg[i] == -1)
+        {
+            agg[i] = numAgg++;
+            coarseBlocks.push_back(blocks[i]);
+        }
+
+    // tentative piecewise constant prolongation
+    gsSparseMatrix<T> tentative(n,numAgg);
+    gsSparseEntries<T> entries;
+    entries.reserve(n);
+    for (index_t i = 0; i < n; ++i)
+        entries.add(i,agg[i],1.);
+    tentative.setFrom(entries);
+
+    // smoothing with one step of damped Jacobi on the filtered matrix: P = (I - omega*D^{-1}*A_filt)*P_tent
+    gsVector<T> invDiag(n);
+    for (index_t i = 0; i < n; ++i)
+        invDiag(i) = diag(i) != 0. ? m_damping/A.coeff(i,i) : 0.;
+    gsSparseMatrix<T> smoothing = invDiag.asDiagonal()*Afilt;
+    P = tentative - smoothing*tentative;
+    P.prune(T(0));
+    P.makeCompressed();
+}
+
+template <class T>
+void gsElAMGOp<T>::cycle(size_t level, const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+{
+    if (level + 1 == m_matrices.size())
+    {
+        x = m_coarseSolver.solve(rhs);
+        return;
+    }
+
+    const gsSparseMatrix<T> & A = m_matrices[level];
+    const gsVector<T> & invDiag = m_invDiags[level];
+    x.setZero(rhs.rows(),rhs.cols());
+    for (index_t s = 0; s < m_smoothingSteps; ++s)
+        x += m_damping*invDiag.asDiagonal()*(rhs - A*x);
+
+    gsMatrix<T> coarseRhs = m_prolongations[level].transpose()*(rhs - A*x);
+    gsMatrix<T> coarseX;
+    cycle(level+1,coarseRhs,coarseX);
+    x += m_prolongations[level]*coarseX;
+
+    for (index_t s = 0; s < m_smoothingSteps; ++s)
+        x += m_damping*invDiag.asDiagonal()*(rhs - A*x);
+}
+
+template <class T>
+void gsElAMGOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+{
+    cycle(0,input,x);
+}
+
+//--------------------- SADDLE-POINT SYSTEMS ----------------------------------//
+
+template <class T>
+gsElBlockTriangularOp<T>::gsElBlockTriangularOp(const gsSparseMatrix<T> & matrix, index_t numPres,
+                                                const typename gsLinearOperator<T>::Ptr & velocityPrecond)
+    : m_numVel(matrix.rows()-numPres),
+      m_numPres(numPres),
+      m_velocityPrecond(velocityPrecond),
+      m_approx(schur_approx::mass)
+{
+    GISMO_ENSURE(numPres > 0 && numPres < matrix.rows(),"Invalid size of the pressure block: " + util::to_string(numPres));
+    m_B1 = matrix.block(0,m_numVel,m_numVel,m_numPres);
+    m_B2 = matrix.block(m_numVel,0,m_numPres,m_numVel);
+    m_C = matrix.block(m_numVel,m_numVel,m_numPres,m_numPres);
+    gsSparseMatrix<T> B1t = m_B1.transpose();
+    m_sign = m_B2.cwiseProduct(B1t).sum() >= 0. ? 1. : -1.;
+}
+
+template <class T>
+void gsElBlockTriangularOp<T>::setMassSchur(const gsSparseMatrix<T> & mass, T coef)
+{
+    GISMO_ENSURE(mass.rows() == m_numPres && coef > 0.,"Invalid pressure mass matrix or coefficient.");
+    m_approx = schur_approx::mass;
+    gsSparseMatrix<T> schur = m_C - m_sign/coef*mass;
+    schur.makeCompressed();
+    m_solverLeft.compute(schur);
+    GISMO_ENSURE(m_solverLeft.info() == Eigen::Success,"Factorization of the Schur complement approximation failed.");
+}
+
+template <class T>
+void gsElBlockTriangularOp<T>::setPCDSchur(const gsSparseMatrix<T> & mass, const gsSparseMatrix<T> & laplacian,
+                                           const gsSparseMatrix<T> & convDiff)
+{
+    GISMO_ENSURE(mass.rows() == m_numPres && laplacian.rows() == m_numPres && convDiff.rows() == m_numPres,
+                 "Invalid size of the pressure operators.");
+    m_approx = schur_approx::PCD;
+    m_middle = convDiff;
+    m_solverLeft.compute(mass);
+    GISMO_ENSURE(m_solverLeft.info() == Eigen::Success,"Factorization of the pressure mass matrix failed.");
+    // the pure Neumann Laplacian is singular; a small mass shift fixes the constant mode
+    gsSparseMatrix<T> shifted = laplacian + (1e-8*laplacian.diagonal().sum()/mass.diagonal().sum())*mass;
+    shifted.makeCompressed();
+    m_solverRight.compute(shifted);
+    GISMO_ENSURE(m_solverRight.info() == Eigen::Success,"Factorization of the pressure Laplacian failed.");
+}
+
+template <class T>
+void gsElBlockTriangularOp<T>::setLSCSchur(const gsSparseMatrix<T> & matrix)
+{
+    m_approx = schur_approx::LSC;
+    gsVector<T> invDiag = matrix.diagonal().head(m_numVel);
+    for (index_t i = 0; i < m_numVel; ++i)
+        invDiag(i) = invDiag(i) != 0. ? 1./invDiag(i) : 1.;
+    const gsSparseMatrix<T> A = matrix.block(0,0,m_numVel,m_numVel);
+    const gsSparseMatrix<T> scaledB1 = invDiag.asDiagonal()*m_B1;
+    gsSparseMatrix<T> Q = m_B2*scaledB1;
+    m_middle = (m_B2*invDiag.asDiagonal())*(A*scaledB1);
+    m_middle.makeCompressed();
+    // Q is singular if the pressure is only defined up to a constant
+    gsSparseMatrix<T> shift(m_numPres,m_numPres);
+    shift.setIdentity();
+    Q += (1e-8*math::abs(Q.diagonal().sum())/m_numPres)*shift;
+    Q.makeCompressed();
+    m_solverLeft.compute(Q);
+    GISMO_ENSURE(m_solverLeft.info() == Eigen::Success,"Factorization of the LSC pressure operator failed.");
+}
+
+template <class T>
+void gsElBlockTriangularOp<T>::applySchurInverse(const gsMatrix<T> & input, gsMatrix<T> & x) const
+{
+    if (m_approx == schur_approx::mass)
+        x = m_solverLeft.solve(input);
+    else if (m_approx == schur_approx::PCD)
+    {
+        gsMatrix<T> temp = m_solverRight.solve(input);
+        x = -m_sign*m_solverLeft.solve(m_middle*temp);
+    }
+    else // the signs of the coupling blocks cancel out
+    {
+        gsMatrix<T> temp = m_solverLeft.solve(input);
+        x = -m_solverLeft.solve(m_middle*temp);
+    }
+}
+
+template <class T>
+void gsElBlockTriangularOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+{
+    x.resize(input.rows(),input.cols());
+    gsMatrix<T> pressure, velocity;
+    applySchurInverse(input.bottomRows(m_numPres),pressure);
+    gsMatrix<T> velocityRhs = input.topRows(m_numVel) - m_B1*pressure;
+    if (m_velocityPrecond)
+        m_velocityPrecond->apply(velocityRhs,velocity);
+    else
+        velocity.swap(velocityRhs);
+    x.topRows(m_numVel) = velocity;
+    x.bottomRows(m_numPres) = pressure;
+}
+
+//--------------------- FACTORY ----------------------------------//
+
+template <class T>
+typename gsLinearOperator<T>::Ptr makeElPreconditioner(index_t precondType, const gsSparseMatrix<T> & matrix,
+                                                       const std::vector<index_t> & blockSizes)
+{
+    typedef typename gsLinearOperator<T>::Ptr OpPtr;
+    if (precondType == linear_precond::none)
+        return OpPtr();
+    if (precondType == linear_precond::jacobi)
+        return OpPtr(new gsElJacobiOp<T>(matrix));
+    if (precondType == linear_precond::ILUT)
+        return OpPtr(new gsElILUTOp<T>(matrix));
+    if (precondType == linear_precond::IC0)
+        return OpPtr(new gsElICOp<T>(matrix));
+    if (precondType == linear_precond::block_jacobi)
+        return OpPtr(new gsElBlockJacobiOp<T>(matrix,blockSizes.empty() ? std::vector<index_t>(1,matrix.rows()) : blockSizes));
+    if (precondType == linear_precond::AMG)
+        return OpPtr(new gsElAMGOp<T>(matrix,blockSizes));
+    GISMO_ERROR("Preconditioner not supported: " + util::to_string(precondType));
+}
+
+} // namespace ends
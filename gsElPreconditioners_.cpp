@@ -0,0 +1,17 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsElPreconditioners.h>
+#include <gsElasticity/gsElPreconditioners.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsElJacobiOp<real_t>;
+    CLASS_TEMPLATE_INST gsElILUTOp<real_t>;
+    CLASS_TEMPLATE_INST gsElICOp<real_t>;
+    CLASS_TEMPLATE_INST gsElBlockJacobiOp<real_t>;
+    CLASS_TEMPLATE_INST gsElAMGOp<real_t>;
+    CLASS_TEMPLATE_INST gsElBlockTriangularOp<real_t>;
+
+    TEMPLATE_INST gsLinearOperator<real_t>::Ptr makeElPreconditioner(index_t precondType, const gsSparseMatrix<real_t> & matrix,
+                                                                     const std::vector<index_t> & blockSizes);
+}
@@ -15,6 +15,8 @@
 #pragma once
 
 #include <gsElasticity/gsBaseAssembler.h>
+#include <gsElasticity/gsLinearSolverCache.h>
+#include <gsElasticity/gsSparseCombination.h>
 #include <gsElasticity/gsBaseUtils.h>
 
 namespace gismo
@@ -25,7 +27,11 @@ class gsElasticityAssembler;
 template <class T>
 class gsMassAssembler;
 
-/** @brief Time integation for equations of dynamic elasticity with implicit schemes
+/** @brief Time integation for equations of dynamic elasticity with implicit and explicit schemes.
+ * Implicit schemes use the Newmark method or the generalized-alpha method of Chung and Hulbert
+ * (option "GenAlpha") with the high-frequency dissipation controlled by the spectral radius "RhoInf". Explicit schemes use the central difference method
+ * which only requires a residual evaluation and a solve with the mass matrix (or a division by the lumped mass) per time step;
+ * they are conditionally stable, see criticalTimeStep().
 */
 template <class T>
 class gsElTimeIntegrator : public gsBaseAssembler<T>
@@ -62,13 +68,49 @@ public:
     /// make a time step according to a chosen scheme
     void makeTimeStep(T timeStep);
 
+    /// @brief Starts an implicit time step without solving it: assemble() then yields the effective system of the time step,
+    /// and an external nonlinear solver (e.g. gsMonolithicFSI) passes the converged solution to finishTimeStep()
+    void beginTimeStep(T timeStep);
+
+    /// accept the solution of the time step started by beginTimeStep() and update velocity and acceleration
+    void finishTimeStep(const gsMatrix<T> & solutionVector, index_t numIterations);
+
+    /// @brief Make a time step with error control. The local error is estimated with the Zienkiewicz-Xie indicator
+    /// e = (beta-1/6)*dt^2*(a_n+1 - a_n). Returns true if the step is accepted; otherwise, the state is recovered.
+    /// In both cases, *nextTimeStep* is the proposed size of the next (or the repeated) time step
+    /// which also accounts for the number of Newton's iterations. A step of the minimal size is accepted
+    /// regardless of the error estimate unless Newton's method fails; check solverStatus() if false is returned
+    /// at the minimal step, since repeating the step will not help.
+    bool makeAdaptiveTimeStep(T timeStep, T & nextTimeStep);
+
+    /// @brief Returns an upper bound for the stable time step of the explicit schemes at the current configuration:
+    /// dt_crit = 2/omega_max, where omega_max^2 is estimated by the Gershgorin bound on M_L^-1*K with the lumped mass M_L
+    T criticalTimeStep();
+
     /// assemble the linear system for the nonlinear solver
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDoFs);
 
+    /// assemble only the residual for the nonlinear solver; the effective matrix stays untouched
+    virtual bool assembleResidual(const gsMatrix<T> & solutionVector,
+                                  const std::vector<gsMatrix<T> > & fixedDoFs);
+
+    virtual bool hasResidualAssembly() const { return stiffAssembler.hasResidualAssembly(); }
+
     /// return the number of free degrees of freedom
     virtual int numDofs() const { return stiffAssembler.numDofs(); }
 
+    /// pressure mass matrix of the stiffness assembler scaled to the Schur complement of the effective system
+    virtual T assembleSchurOperators(const gsMatrix<T> & solutionVector,
+                                     const std::vector<gsMatrix<T> > & fixedDoFs,
+                                     gsSparseMatrix<T> & mass,
+                                     gsSparseMatrix<T> & laplacian,
+                                     gsSparseMatrix<T> & convDiff)
+    { return stiffAssembler.assembleSchurOperators(solutionVector,fixedDoFs,mass,laplacian,convDiff)/(1-alphaF()); }
+
+    /// block structure of the stiffness assembler
+    virtual std::vector<index_t> freeBlockSizes() const { return stiffAssembler.freeBlockSizes(); }
+
     /// returns complete solution vector (displacement + possibly pressure)
     const gsMatrix<T> & solutionVector() const { return solVector; }
 
@@ -87,6 +129,9 @@ public:
     /// number of iterations Newton's method required at the last time step
     index_t numberIterations() const { return numIters;}
 
+    /// status of Newton's method at the last time step
+    solver_status solverStatus() const { return newtonStatus; }
+
     /// construct displacement using the stiffness assembler
     void constructSolution(gsMultiPatch<T> & displacement) const;
 
@@ -100,17 +145,49 @@ public:
 protected:
     void initialize();
 
+    /// returns true if the stiffness assembler uses a linear material law
+    bool linearMaterial();
+
     /// time integraton schemes
     gsMatrix<T> implicitLinear();
+    /// form the effective matrix (1-alpha_m)*alpha1*M + (1-alpha_f)*K using the current stiffness matrix
+    void formEffectiveMatrix();
+    /// assemble the stiffness matrix (or only the residual) at the intermediate configuration
+    /// u_n+1-alpha_f = (1-alpha_f)*u_n+1 + alpha_f*u_n; for the Newmark method, at u_n+1
+    bool assembleStiffness(const gsMatrix<T> & solutionVector,
+                           const std::vector<gsMatrix<T> > & fixedDoFs, bool assembleMatrix);
     gsMatrix<T> implicitNonlinear();
+    void explicitCentral();
+
+    /// assembles the forces f - f_int(u) at the current displacement for the explicit schemes;
+    /// for linear materials, computed as f - K*u; returns false if the configuration is invalid
+    bool assembleForces();
+
+    /// assembles the stiffness matrix of a linear material once, with the elimination matrix;
+    /// afterwards, only the rhs is updated for the given Dirichlet DoFs
+    void assembleLinearStiffness(const std::vector<gsMatrix<T> > & ddofs);
+
+    /// computes the acceleration from the forces using the consistent or the lumped mass matrix
+    void computeAcceleration();
+
+    /// compute the rhs of the nonlinear solver given the current solution and the rhs of the stiffness assembler
+    void assembleRhs(const gsMatrix<T> & solutionVector);
 
     /// time integration scheme coefficients
-    T alpha1() {return 1./m_options.getReal("Beta")/pow(tStep,2); }
-    T alpha2() {return 1./m_options.getReal("Beta")/tStep; }
-    T alpha3() {return (1-2*m_options.getReal("Beta"))/2/m_options.getReal("Beta"); }
-    T alpha4() {return m_options.getReal("Gamma")/m_options.getReal("Beta")/tStep; }
-    T alpha5() {return 1 - m_options.getReal("Gamma")/m_options.getReal("Beta"); }
-    T alpha6() {return (1-m_options.getReal("Gamma")/m_options.getReal("Beta")/2)*tStep; }
+    T alpha1() {return 1./beta()/pow(tStep,2); }
+    T alpha2() {return 1./beta()/tStep; }
+    T alpha3() {return (1-2*beta())/2/beta(); }
+    T alpha4() {return gamma()/beta()/tStep; }
+    T alpha5() {return 1 - gamma()/beta(); }
+    T alpha6() {return (1-gamma()/beta()/2)*tStep; }
+
+    /// generalized-alpha parameters, see Chung & Hulbert, J. Appl. Mech. 60 (1993); both are zero for the Newmark method
+    T alphaM() {return m_options.getSwitch("GenAlpha") ? (2*rhoInf()-1)/(rhoInf()+1) : 0.; }
+    T alphaF() {return m_options.getSwitch("GenAlpha") ? rhoInf()/(rhoInf()+1) : 0.; }
+    T rhoInf() {return m_options.getReal("RhoInf"); }
+    /// Newmark parameters; computed from alpha_m and alpha_f for the generalized-alpha method
+    T beta() {return m_options.getSwitch("GenAlpha") ? pow(1-alphaM()+alphaF(),2)/4 : m_options.getReal("Beta"); }
+    T gamma() {return m_options.getSwitch("GenAlpha") ? 0.5-alphaM()+alphaF() : m_options.getReal("Gamma"); }
 
 protected:
     /// assembler object that generates the static system
@@ -132,6 +209,8 @@ protected:
     using Base::m_ddof;
     /// number of iterations Newton's method took to converge at the last time step
     index_t numIters;
+    /// status of Newton's method at the last time step; always converged for linear and explicit schemes
+    solver_status newtonStatus;
     /// saved state
     bool hasSavedState;
     gsMatrix<T> solVecSaved;
@@ -140,7 +219,22 @@ protected:
     std::vector<gsMatrix<T> > ddofsSaved;
     /// temporary objects for memory efficiency
     gsMatrix<T> newSolVector, oldVelVector, dispVectorDiff;
-    gsSparseMatrix<T> tempMassBlock;
+    /// in-place combination of M and K with a fixed sparsity pattern
+    gsSparseCombination<T> matCombination;
+    /// factorized mass matrix and the lumped mass vector for the explicit schemes
+    gsLinearSolverCache<T> massSolver;
+    gsMatrix<T> lumpedMass, forceVector;
+    /// true if the stiffness matrix of a linear material is assembled, see assembleLinearStiffness()
+    bool linearAssembled;
+    /// factorized effective matrix for the linear implicit scheme;
+    /// valid as long as the coefficients in front of M and K are unchanged
+    gsLinearSolverCache<T> effSolver;
+    bool effMatrixCached;
+    T effMassCoef, effStiffCoef;
+    /// Dirichlet DoFs at the beginning of the time step and temporary objects for the generalized-alpha method
+    std::vector<gsMatrix<T> > oldDdofs;
+    gsMatrix<T> alphaSolVector;
+    std::vector<gsMatrix<T> > alphaDdofs;
 };
 
 }
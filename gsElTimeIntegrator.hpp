@@ -34,7 +34,11 @@ gsElTimeIntegrator<T>::gsElTimeIntegrator(gsElasticityAssembler<T> & stiffAssemb
     m_options = defaultOptions();
     m_ddof = stiffAssembler.allFixedDofs();
     numIters = 0;
+    newtonStatus = solver_status::converged;
     hasSavedState = false;
+    effMatrixCached = false;
+    linearAssembled = false;
+    effSolver.setSolver(linear_solver::LDLT);
     solVector = gsMatrix<T>::Zero(stiffAssembler.numDofs(),1);
     velVector = gsMatrix<T>::Zero(massAssembler.numDofs(),1);
     accVector = gsMatrix<T>::Zero(massAssembler.numDofs(),1);
@@ -47,17 +51,51 @@ gsOptionList gsElTimeIntegrator<T>::defaultOptions()
     opt.addInt("Scheme","Time integration scheme",time_integration::implicit_linear);
     opt.addReal("Beta","Parameter beta for the time integration scheme, see Wriggers, Nonlinear FEM, p.213 ",0.25);
     opt.addReal("Gamma","Parameter gamma for the time integration scheme, see Wriggers, Nonlinear FEM, p.213 ",0.5);
+    opt.addSwitch("GenAlpha","Use the generalized-alpha method; Beta and Gamma are then computed from RhoInf",false);
+    opt.addReal("RhoInf","Spectral radius at infinite frequency for the generalized-alpha method: 1 - no dissipation, 0 - maximal dissipation",0.8);
+    opt.addSwitch("HRZLumping","Use the HRZ lumping instead of the row-sum lumping for the explicit scheme with lumped mass",false);
     opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all",solver_verbosity::none);
+    /// linear solver for Newton's method, see gsIterative
+    opt.addInt("Solver","Linear solver to use",linear_solver::LDLT);
+    opt.addInt("Precond","Preconditioner for the Krylov solvers",linear_precond::block_triangular);
+    opt.addInt("SchurApprox","Schur complement approximation of the block-triangular preconditioner",schur_approx::mass);
+    /// adaptive time stepping
+    opt.addReal("ErrRelTol","Relative tolerance for the local time error in adaptive time stepping",1e-3);
+    opt.addReal("ErrAbsTol","Absolute tolerance for the local time error in adaptive time stepping",1e-10);
+    opt.addReal("MinTimeStep","Minimal time step in adaptive time stepping",1e-8);
+    opt.addReal("MaxTimeStep","Maximal time step in adaptive time stepping",1e8);
+    opt.addInt("TargetIters","Adaptive time stepping reduces the time step if Newton's method needs more iterations",8);
     return opt;
 }
 
 template <class T>
 void gsElTimeIntegrator<T>::initialize()
 {
-    stiffAssembler.assemble(solVector,m_ddof);
     massAssembler.assemble();
-    gsSparseSolver<>::SimplicialLDLT solver(massAssembler.matrix());
-    accVector = solver.solve(stiffAssembler.rhs().middleRows(0,massAssembler.numDofs()));
+    effMatrixCached = false;
+    linearAssembled = false;
+    oldDdofs = m_ddof;
+    massSolver.setSolver(linear_solver::LDLT);
+    massSolver.factorize(massAssembler.matrix());
+    lumpedMass.resize(0,1);
+    if (m_options.getInt("Scheme") == time_integration::explicit_ ||
+        m_options.getInt("Scheme") == time_integration::explicit_lumped)
+    {   // explicit schemes need only the internal forces
+        GISMO_ENSURE(massAssembler.numDofs() == stiffAssembler.numDofs(),
+                     "Explicit schemes are not available for the displacement-pressure formulation");
+        GISMO_ENSURE(assembleForces(),"Invalid initial configuration");
+        computeAcceleration();
+    }
+    else if (linearMaterial())
+    {   // the stiffness matrix of a linear problem is assembled once, see assembleLinearStiffness()
+        assembleLinearStiffness(m_ddof);
+        accVector = massSolver.solve((stiffAssembler.rhs() - stiffAssembler.matrix()*solVector).middleRows(0,massAssembler.numDofs()));
+    }
+    else
+    {
+        stiffAssembler.assemble(solVector,m_ddof);
+        accVector = massSolver.solve(stiffAssembler.rhs().middleRows(0,massAssembler.numDofs()));
+    }
     initialized = true;
 }
 
@@ -68,48 +106,216 @@ void gsElTimeIntegrator<T>::makeTimeStep(T timeStep)
         initialize();
 
     tStep = timeStep;
+    newtonStatus = solver_status::converged;
+    if (m_options.getInt("Scheme") == time_integration::explicit_ ||
+        m_options.getInt("Scheme") == time_integration::explicit_lumped)
+    {   // explicit schemes update velocity and acceleration themselves
+        explicitCentral();
+        return;
+    }
     if (m_options.getInt("Scheme") == time_integration::implicit_linear)
         newSolVector = implicitLinear();
     if (m_options.getInt("Scheme") == time_integration::implicit_nonlinear)
         newSolVector = implicitNonlinear();
+    finishTimeStep(newSolVector,numIters);
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::beginTimeStep(T timeStep)
+{
+    GISMO_ENSURE(m_options.getInt("Scheme") == time_integration::implicit_linear ||
+                 m_options.getInt("Scheme") == time_integration::implicit_nonlinear,
+                 "Only implicit schemes can be used with an external nonlinear solver");
+    if (!initialized)
+        initialize();
+
+    tStep = timeStep;
+    newtonStatus = solver_status::converged;
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::finishTimeStep(const gsMatrix<T> & solutionVector, index_t numIterations)
+{
+    GISMO_ENSURE(solutionVector.rows() == stiffAssembler.numDofs(),"Wrong size of the solution vector: " + util::to_string(solutionVector.rows()) +
+                 ". Must be: " + util::to_string(stiffAssembler.numDofs()));
     oldVelVector = velVector;
-    dispVectorDiff = (newSolVector - solVector).middleRows(0,massAssembler.numDofs());
+    dispVectorDiff = (solutionVector - solVector).middleRows(0,massAssembler.numDofs());
     velVector = alpha4()*dispVectorDiff + alpha5()*oldVelVector + alpha6()*accVector;
     accVector = alpha1()*dispVectorDiff - alpha2()*oldVelVector - alpha3()*accVector;
-    solVector = newSolVector;
+    solVector = solutionVector;
+    oldDdofs = m_ddof;
+    numIters = numIterations;
 }
 
 template <class T>
-gsMatrix<T> gsElTimeIntegrator<T>::implicitLinear()
+bool gsElTimeIntegrator<T>::makeAdaptiveTimeStep(T timeStep, T & nextTimeStep)
 {
-    if (massAssembler.numDofs() == stiffAssembler.numDofs())
-    {   // displacement formulation
-        m_system.matrix() = alpha1()*massAssembler.matrix() + stiffAssembler.matrix();
-        m_system.matrix().makeCompressed();
-        m_system.rhs() = massAssembler.matrix()*(alpha1()*solVector.middleRows(0,massAssembler.numDofs())
-                                                 + alpha2()*velVector + alpha3()*accVector) + stiffAssembler.rhs();
+    const T minStep = m_options.getReal("MinTimeStep");
+    saveState(); // also keeps a_n
+    makeTimeStep(timeStep);
+
+    if (newtonStatus != solver_status::converged)
+    {   // Newton's method failed: repeat with a smaller step; at the minimal step, the failure
+        // is reported by solverStatus() and the state stays at the beginning of the time step
+        recoverState();
+        nextTimeStep = math::max(timeStep/2,minStep);
+        return false;
+    }
+
+    // Zienkiewicz-Xie local error estimate; beta = 0 for the central difference method
+    const bool expl = m_options.getInt("Scheme") == time_integration::explicit_ ||
+                      m_options.getInt("Scheme") == time_integration::explicit_lumped;
+    const T b = expl ? 0. : beta();
+    const T errNorm = math::abs(b-1./6)*timeStep*timeStep*(accVector-accVecSaved).norm();
+    const T error = errNorm/(m_options.getReal("ErrAbsTol") +
+                             m_options.getReal("ErrRelTol")*solVector.middleRows(0,massAssembler.numDofs()).norm());
+
+    // the estimate is of order 3 in dt
+    nextTimeStep = timeStep*timeStepFactor<T>(error,3,numIters,m_options.getInt("TargetIters"));
+    nextTimeStep = math::min(math::max(nextTimeStep,minStep),m_options.getReal("MaxTimeStep"));
+    if (error > 1. && timeStep > minStep)
+    {
+        recoverState();
+        return false;
+    }
+    return true;
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::explicitCentral()
+{
+    GISMO_ENSURE(massAssembler.numDofs() == stiffAssembler.numDofs(),
+                 "Explicit schemes are not available for the displacement-pressure formulation");
+    // central difference method in the velocity form:
+    // v_n+1/2 = v_n + dt/2*a_n, u_n+1 = u_n + dt*v_n+1/2, a_n+1 = M^-1*(f - f_int(u_n+1)), v_n+1 = v_n+1/2 + dt/2*a_n+1
+    velVector.noalias() += tStep/2*accVector;
+    solVector.noalias() += tStep*velVector;
+    // internal forces at the new configuration; only the residual is needed
+    GISMO_ENSURE(assembleForces(),
+                 "Invalid configuration. The time step is probably larger than the critical one.");
+    computeAcceleration();
+    velVector.noalias() += tStep/2*accVector;
+    numIters = 1;
+}
+
+template <class T>
+bool gsElTimeIntegrator<T>::assembleForces()
+{
+    if (linearMaterial())
+    {   // the residual of a linear problem is f - K*u with the stiffness matrix assembled once
+        assembleLinearStiffness(m_ddof);
+        forceVector = stiffAssembler.rhs();
+        forceVector.noalias() -= stiffAssembler.matrix()*solVector;
+        return true;
+    }
+    if (!stiffAssembler.assembleResidual(solVector,m_ddof))
+        return false;
+    forceVector = stiffAssembler.rhs();
+    return true;
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::assembleLinearStiffness(const std::vector<gsMatrix<T> > & ddofs)
+{
+    // the matrix is assembled with homogeneous Dirichlet DoFs, so that the saved rhs contains no Dirichlet contribution
+    if (!linearAssembled || !stiffAssembler.hasEliminationMatrix())
+    {
+        stiffAssembler.homogenizeFixedDofs(-1);
+        stiffAssembler.assemble(true);
+        linearAssembled = true;
+        effMatrixCached = false;
+    }
+    // new Dirichlet data: a sparse matrix-vector product instead of a new assembly
+    const std::vector<gsMatrix<T> > & stiffDdofs = stiffAssembler.allFixedDofs();
+    bool ddofsChanged = false;
+    for (size_t d = 0; d < ddofs.size() && !ddofsChanged; ++d)
+        ddofsChanged = ddofs[d] != stiffDdofs[d];
+    if (ddofsChanged)
+    {
+        stiffAssembler.setFixedDofs(ddofs);
+        stiffAssembler.eliminateFixedDofs();
+    }
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::computeAcceleration()
+{
+    if (m_options.getInt("Scheme") == time_integration::explicit_lumped)
+    {
+        if (lumpedMass.rows() != massAssembler.numDofs())
+            massAssembler.lumpedMassVector(lumpedMass,m_options.getSwitch("HRZLumping"));
+        accVector = forceVector.cwiseQuotient(lumpedMass);
     }
     else
-    {   // displacement-pressure formulation
-        m_system.matrix() = stiffAssembler.matrix();
-        tempMassBlock = alpha1()*massAssembler.matrix();
-        tempMassBlock.conservativeResize(stiffAssembler.numDofs(),massAssembler.numDofs());
-        m_system.matrix().leftCols(massAssembler.numDofs()) += tempMassBlock;
-        m_system.matrix().makeCompressed();
-        m_system.rhs() = stiffAssembler.rhs();
-        m_system.rhs().middleRows(0,massAssembler.numDofs()) +=
-                massAssembler.matrix()*(alpha1()*solVector.middleRows(0,massAssembler.numDofs())
-                                        + alpha2()*velVector + alpha3()*accVector);
+        accVector = massSolver.solve(forceVector);
+}
+
+template <class T>
+T gsElTimeIntegrator<T>::criticalTimeStep()
+{
+    if (!initialized)
+        initialize();
+    GISMO_ENSURE(massAssembler.numDofs() == stiffAssembler.numDofs(),
+                 "Explicit schemes are not available for the displacement-pressure formulation");
+    if (lumpedMass.rows() != massAssembler.numDofs())
+        massAssembler.lumpedMassVector(lumpedMass,m_options.getSwitch("HRZLumping"));
+    // tangent stiffness at the current configuration
+    if (linearMaterial())
+        assembleLinearStiffness(m_ddof);
+    else
+    {
+        stiffAssembler.assemble(solVector,m_ddof);
+        effMatrixCached = false;
     }
+    // Gershgorin bound: omega_max^2 <= max_i sum_j |K_ij| / m_i
+    gsMatrix<T> rowSums = stiffAssembler.matrix().cwiseAbs() * gsMatrix<T>::Ones(stiffAssembler.numDofs(),1);
+    return 2./math::sqrt(rowSums.cwiseQuotient(lumpedMass).maxCoeff());
+}
+
+template <class T>
+bool gsElTimeIntegrator<T>::linearMaterial()
+{
+    return stiffAssembler.options().getInt("MaterialLaw") == material_law::hooke ||
+           stiffAssembler.options().getInt("MaterialLaw") == material_law::mixed_hooke;
+}
+
+template <class T>
+gsMatrix<T> gsElTimeIntegrator<T>::implicitLinear()
+{
+    // Dirichlet DoFs at the intermediate time: u_D,n+1-alpha_f = (1-alpha_f)*u_D,n+1 + alpha_f*u_D,n
+    const T af = alphaF();
+    alphaDdofs.resize(m_ddof.size());
+    for (size_t d = 0; d < m_ddof.size(); ++d)
+        alphaDdofs[d] = (1-af)*m_ddof[d] + af*oldDdofs[d];
+    assembleLinearStiffness(alphaDdofs);
+    // the effective matrix only changes with the time step or the scheme parameters
+    if (!effMatrixCached || (1-alphaM())*alpha1() != effMassCoef || 1-alphaF() != effStiffCoef)
+    {
+        formEffectiveMatrix();
+        effSolver.factorize(m_system.matrix());
+        effMatrixCached = true;
+        effMassCoef = (1-alphaM())*alpha1();
+        effStiffCoef = 1-alphaF();
+    }
+
+    // rhs = F - K_FD*u_D,n+1-alpha_f - alpha_f*K*u_n + M*((1-alpha_m)*(alpha1*u_n + alpha2*v_n + alpha3*a_n) - alpha_m*a_n)
+    m_system.rhs() = stiffAssembler.rhs();
+    if (af != 0.)
+        m_system.rhs().noalias() -= af*stiffAssembler.matrix()*solVector;
+    m_system.rhs().middleRows(0,massAssembler.numDofs()) +=
+            massAssembler.matrix()*((1-alphaM())*(alpha1()*solVector.middleRows(0,massAssembler.numDofs())
+                                    + alpha2()*velVector + alpha3()*accVector) - alphaM()*accVector);
 
-#ifdef GISMO_WITH_PARDISO
-    gsSparseSolver<>::PardisoLDLT solver(m_system.matrix());
-    return solver.solve(m_system.rhs());
-#else
-    gsSparseSolver<>::SimplicialLDLT solver(m_system.matrix());
-    return solver.solve(m_system.rhs());
-#endif
     numIters = 1;
+    return effSolver.solve(m_system.rhs());
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::formEffectiveMatrix()
+{
+    // the mass matrix is added to the displacement block of the stiffness matrix
+    // (the whole matrix for the displacement formulation); the pattern is reused between calls
+    matCombination.compute(stiffAssembler.matrix(),1-alphaF(),massAssembler.matrix(),(1-alphaM())*alpha1(),m_system.matrix());
 }
 
 template <class T>
@@ -117,9 +323,14 @@ gsMatrix<T> gsElTimeIntegrator<T>::implicitNonlinear()
 {
     gsIterative<T> solver(*this,solVector);
     solver.options().setInt("Verbosity",m_options.getInt("Verbosity"));
-    solver.options().setInt("Solver",linear_solver::LDLT);
+    solver.options().setInt("Solver",m_options.getInt("Solver"));
+    solver.options().setInt("Precond",m_options.getInt("Precond"));
+    solver.options().setInt("SchurApprox",m_options.getInt("SchurApprox"));
     solver.solve();
     numIters = solver.numberIterations();
+    newtonStatus = solver.solverStatus();
+    // the solver homogenizes the fixed DoFs of the integrator; recover them
+    m_ddof = solver.allFixedDofs();
     return solver.solution();
 }
 
@@ -127,30 +338,55 @@ template <class T>
 bool gsElTimeIntegrator<T>::assemble(const gsMatrix<T> & solutionVector,
                                      const std::vector<gsMatrix<T> > & fixedDoFs)
 {
-    stiffAssembler.assemble(solutionVector,fixedDoFs);
-    if (massAssembler.numDofs() == stiffAssembler.numDofs())
-    {   // displacement formulation
-        m_system.matrix() = alpha1()*massAssembler.matrix() + stiffAssembler.matrix();
-        m_system.matrix().makeCompressed();
-        m_system.rhs() = stiffAssembler.rhs() +
-                         massAssembler.matrix()*(alpha1()*(solVector-solutionVector) + alpha2()*velVector + alpha3()*accVector);
-    }
-    else
-    {   // displacement-pressure formulation
-        m_system.matrix() = stiffAssembler.matrix();
-        tempMassBlock = alpha1()*massAssembler.matrix();
-        tempMassBlock.conservativeResize(stiffAssembler.numDofs(),massAssembler.numDofs());
-        m_system.matrix().leftCols(massAssembler.numDofs()) += tempMassBlock;
-        m_system.matrix().makeCompressed();
-        m_system.rhs() = stiffAssembler.rhs();
-        m_system.rhs().middleRows(0,massAssembler.numDofs()) +=
-                massAssembler.matrix()*(alpha1()*(solVector-solutionVector).middleRows(0,massAssembler.numDofs())
-                                        + alpha2()*velVector + alpha3()*accVector);
-    }
+    if (!assembleStiffness(solutionVector,fixedDoFs,true))
+        return false;
+    // the stiffness matrix has changed; the cached effective matrix of the linear scheme is outdated
+    effMatrixCached = false;
+    formEffectiveMatrix();
+    assembleRhs(solutionVector);
 
     return true;
 }
 
+template <class T>
+bool gsElTimeIntegrator<T>::assembleResidual(const gsMatrix<T> & solutionVector,
+                                             const std::vector<gsMatrix<T> > & fixedDoFs)
+{
+    if (!assembleStiffness(solutionVector,fixedDoFs,false))
+        return false;
+    assembleRhs(solutionVector);
+
+    return true;
+}
+
+template <class T>
+bool gsElTimeIntegrator<T>::assembleStiffness(const gsMatrix<T> & solutionVector,
+                                              const std::vector<gsMatrix<T> > & fixedDoFs, bool assembleMatrix)
+{
+    const T af = alphaF();
+    if (af == 0.) // Newmark
+        return assembleMatrix ? stiffAssembler.assemble(solutionVector,fixedDoFs)
+                              : stiffAssembler.assembleResidual(solutionVector,fixedDoFs);
+
+    // generalized-alpha: displacement, pressure and Dirichlet DoFs are interpolated between t_n and t_n+1
+    alphaSolVector = (1-af)*solutionVector + af*solVector;
+    alphaDdofs.resize(fixedDoFs.size());
+    for (size_t d = 0; d < fixedDoFs.size(); ++d)
+        alphaDdofs[d] = (1-af)*fixedDoFs[d] + af*oldDdofs[d];
+    return assembleMatrix ? stiffAssembler.assemble(alphaSolVector,alphaDdofs)
+                          : stiffAssembler.assembleResidual(alphaSolVector,alphaDdofs);
+}
+
+template <class T>
+void gsElTimeIntegrator<T>::assembleRhs(const gsMatrix<T> & solutionVector)
+{
+    // rhs = F - F_int(u_n+1-alpha_f) - M*((1-alpha_m)*a_n+1 + alpha_m*a_n)
+    m_system.rhs() = stiffAssembler.rhs();
+    m_system.rhs().middleRows(0,massAssembler.numDofs()) +=
+            massAssembler.matrix()*((1-alphaM())*(alpha1()*(solVector-solutionVector).middleRows(0,massAssembler.numDofs())
+                                    + alpha2()*velVector + alpha3()*accVector) - alphaM()*accVector);
+}
+
 template <class T>
 void gsElTimeIntegrator<T>::constructSolution(gsMultiPatch<T> & displacement) const
 {
@@ -185,6 +421,7 @@ void gsElTimeIntegrator<T>::recoverState()
     velVector = velVecSaved;
     accVector = accVecSaved;
     m_ddof = ddofsSaved;
+    oldDdofs = ddofsSaved;
 }
 
 
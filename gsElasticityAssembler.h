@@ -18,6 +18,7 @@
 #include <gsElasticity/gsBaseAssembler.h>
 #include <gsElasticity/gsElasticityFunctions.h>
 #include <gsElasticity/gsBaseUtils.h>
+#include <gsElasticity/gsElementCache.h>
 
 namespace gismo
 {
@@ -63,16 +64,56 @@ public:
     /// Checks if the current solution is valid (Newton's solver can exit safely if invalid).
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDoFs);
+
+    /// Assembles only the residual for Newton's method given the current solution;
+    /// the matrix from the last call to assemble() stays untouched.
+    virtual bool assembleResidual(const gsMatrix<T> & solutionVector,
+                                  const std::vector<gsMatrix<T> > & fixedDoFs);
+
+    virtual bool hasResidualAssembly() const { return true; }
+
+    /// @brief Matrix-free product of the tangential matrix at a given displacement with vectors of free DoFs:
+    /// result = K(displacement)*v. The tangent is evaluated at quadrature points on the fly and never stored;
+    /// the system matrix and the rhs stay untouched. Only for displacement formulation
+    virtual void applyTangent(const gsMultiPatch<T> & displacement, const gsMatrix<T> & v, gsMatrix<T> & result);
+
+    /// true for the displacement formulation with a nonlinear material law
+    virtual bool hasMatrixFreeTangent() const;
+
+    /// matrix-free tangent at the displacement given by the solution vector and fixed DoFs, see above
+    virtual void applyTangent(const gsMatrix<T> & solutionVector,
+                              const std::vector<gsMatrix<T> > & fixedDoFs,
+                              const gsMatrix<T> & v, gsMatrix<T> & result);
+
+    /// @brief Diagonal of the tangential matrix evaluated at quadrature points without storing the matrix;
+    /// the cost per element is linear in the number of active functions. Only for displacement formulation
+    virtual void tangentDiagonal(const gsMatrix<T> & solutionVector,
+                                 const std::vector<gsMatrix<T> > & fixedDoFs,
+                                 gsMatrix<T> & result);
+
+    /// @brief Assembles the pressure mass matrix for the Schur complement preconditioner of the mixed formulation;
+    /// returns the shear modulus. The Laplacian and the convection-diffusion operator are not used for elasticity
+    virtual T assembleSchurOperators(const gsMatrix<T> & solutionVector,
+                                     const std::vector<gsMatrix<T> > & fixedDoFs,
+                                     gsSparseMatrix<T> & mass,
+                                     gsSparseMatrix<T> & laplacian,
+                                     gsSparseMatrix<T> & convDiff);
 protected:
+    /// common implementation of assemble() and assembleResidual() for nonlinear problems
+    virtual bool assembleNonlinear(const gsMatrix<T> & solutionVector,
+                                   const std::vector<gsMatrix<T> > & fixedDoFs,
+                                   bool assembleMatrix);
+
     /// @ brief Assembles the tangential matrix and the residual for a iteration of Newton's method for displacement formulation;
     /// set *assembleMatrix* to false to only assemble the residual;
     /// ATTENTION: rhs() returns a negative residual (-r) !!!
-    virtual void assemble(const gsMultiPatch<T> & displacement);
+    virtual void assemble(const gsMultiPatch<T> & displacement, bool assembleMatrix = true);
 
     /// @ brief Assembles the tangential matrix and the residual for a iteration of Newton's method for mixed formulation;
     /// set *assembleMatrix* to false to only assemble the residual;
     /// ATTENTION: rhs() returns a negative residual (-r) !!!
-    virtual void assemble(const gsMultiPatch<T> & displacement, const gsMultiPatch<T> & pressure);
+    virtual void assemble(const gsMultiPatch<T> & displacement, const gsMultiPatch<T> & pressure,
+                          bool assembleMatrix = true);
 
     //--------------------- SOLUTION CONSTRUCTION ----------------------------------//
 
@@ -105,14 +146,25 @@ public:
                                  gsPiecewiseFunction<T> & result,
                                  stress_components::components component = stress_components::von_mises) const;
 
+    /// @brief Returns the cache of geometry and basis evaluations used for nonlinear problems (see option ElementCache)
+    const gsElementCache<T> & elementCache() const { return m_elementCache; }
+
+    /// @brief Clears the element cache; necessary if the domain has been modified without changing its size
+    void invalidateElementCache() { m_elementCache.invalidate(); }
+
 protected:
     /// a custom reserve function to allocate memory for the sparse matrix
     virtual void reserve();
 
+    /// returns the element cache if it is enabled; recomputes the cache if the domain or the basis have changed
+    const gsElementCache<T> * updateElementCache();
+
 protected:
     /// Dimension of the problem
     /// parametric dim = physical dim = deformation dim
     short_t m_dim;
+    /// geometry and basis evaluations at quadrature points reused by the nonlinear assembly
+    gsElementCache<T> m_elementCache;
 
     using Base::m_pde_ptr;
     using Base::m_bases;
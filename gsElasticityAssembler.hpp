@@ -86,6 +86,8 @@ gsOptionList gsElasticityAssembler<T>::defaultOptions()
     opt.addInt("MaterialLaw","Material law: 0 for St. Venant-Kirchhof, 1 for Neo-Hooke",material_law::hooke);
     opt.addReal("LocalStiff","Stiffening degree for the Jacobian-based local stiffening",0.);
     opt.addSwitch("Check","Check bijectivity of the displacement field before matrix assebmly",false);
+    opt.addSwitch("ElementCache","Reuse geometry and basis evaluations at quadrature points between nonlinear iterations",false);
+    opt.addReal("ElementCacheBudget","Memory budget of the element cache in MB",1024.);
     return opt;
 }
 
@@ -140,36 +142,24 @@ template<class T>
 void gsElasticityAssembler<T>::assemble(bool saveEliminationMatrix)
 {
     m_system.matrix().setZero();
+    Base::eliminationMatrixValid = false;
     reserve();
     m_system.rhs().setZero();
 
     // Compute volumetric integrals and write to the global linear system
+    gsSparseEntries<T> elimEntries;
     if (m_bases.size() == unsigned(m_dim)) // displacement formulation
     {
         GISMO_ENSURE(m_options.getInt("MaterialLaw") == material_law::hooke,
                      "Material law not specified OR not supported!");
-        if (saveEliminationMatrix)
-        {
-            eliminationMatrix.resize(Base::numDofs(),Base::numFixedDofs());
-            eliminationMatrix.setZero();
-            eliminationMatrix.reservePerColumn(m_system.numColNz(m_bases[0],m_options));
-        }
-
-        gsVisitorLinearElasticity<T> visitor(*m_pde_ptr, saveEliminationMatrix ? &eliminationMatrix : nullptr);
+        gsVisitorLinearElasticity<T> visitor(*m_pde_ptr, saveEliminationMatrix ? &elimEntries : nullptr);
         Base::template push<gsVisitorLinearElasticity<T> >(visitor);
-
-        if (saveEliminationMatrix)
-        {
-            Base::rhsWithZeroDDofs = m_system.rhs();
-            eliminationMatrix.makeCompressed();
-        }
-
     }
     else // mixed formulation (displacement + pressure)
     {
         GISMO_ENSURE(m_options.getInt("MaterialLaw") == material_law::mixed_hooke,
                      "Material law not specified OR not supported!");
-        gsVisitorMixedLinearElasticity<T> visitor(*m_pde_ptr);
+        gsVisitorMixedLinearElasticity<T> visitor(*m_pde_ptr, saveEliminationMatrix ? &elimEntries : nullptr);
         Base::template push<gsVisitorMixedLinearElasticity<T> >(visitor);
     }
 
@@ -177,11 +167,30 @@ void gsElasticityAssembler<T>::assemble(bool saveEliminationMatrix)
     Base::template push<gsVisitorElasticityNeumann<T> >(m_pde_ptr->bc().neumannSides());
 
     m_system.matrix().makeCompressed();
+
+    // the saved rhs includes the Neumann contribution which does not depend on the Dirichlet DoFs
+    if (saveEliminationMatrix)
+        Base::setEliminationMatrix(elimEntries);
 }
 
 template <class T>
 bool gsElasticityAssembler<T>::assemble(const gsMatrix<T> & solutionVector,
                                         const std::vector<gsMatrix<T> > & fixedDoFs)
+{
+    return assembleNonlinear(solutionVector,fixedDoFs,true);
+}
+
+template <class T>
+bool gsElasticityAssembler<T>::assembleResidual(const gsMatrix<T> & solutionVector,
+                                                const std::vector<gsMatrix<T> > & fixedDoFs)
+{
+    return assembleNonlinear(solutionVector,fixedDoFs,false);
+}
+
+template <class T>
+bool gsElasticityAssembler<T>::assembleNonlinear(const gsMatrix<T> & solutionVector,
+                                                 const std::vector<gsMatrix<T> > & fixedDoFs,
+                                                 bool assembleMatrix)
 {
     gsMultiPatch<T> displacement;
     constructSolution(solutionVector,fixedDoFs,displacement);
@@ -190,56 +199,162 @@ bool gsElasticityAssembler<T>::assemble(const gsMatrix<T> & solutionVector,
             return false;
 
     if (m_bases.size() == unsigned(m_dim)) // displacement formulation 
-        assemble(displacement);
+        assemble(displacement,assembleMatrix);
     else // mixed formulation (displacement + pressure)
     {
         gsMultiPatch<T> pressure;
         constructPressure(solutionVector,fixedDoFs,pressure);
-        assemble(displacement,pressure);
+        assemble(displacement,pressure,assembleMatrix);
     }
     return true;
 }
 
 template<class T>
-void gsElasticityAssembler<T>::assemble(const gsMultiPatch<T> & displacement)
+void gsElasticityAssembler<T>::assemble(const gsMultiPatch<T> & displacement, bool assembleMatrix)
 {
     GISMO_ENSURE(m_options.getInt("MaterialLaw") == material_law::saint_venant_kirchhoff ||
                  m_options.getInt("MaterialLaw") == material_law::neo_hooke_ln ||
                  m_options.getInt("MaterialLaw") == material_law::neo_hooke_quad,
                  "Material law not specified OR not supported!");
-    m_system.matrix().setZero();
-    reserve();
+    if (assembleMatrix)
+    {
+        m_system.matrix().setZero();
+        Base::eliminationMatrixValid = false;
+        reserve();
+    }
     m_system.rhs().setZero();
 
     // Compute volumetric integrals and write to the global linear system
-    gsVisitorNonLinearElasticity<T> visitor(*m_pde_ptr,displacement);
+    gsVisitorNonLinearElasticity<T> visitor(*m_pde_ptr,displacement,assembleMatrix,updateElementCache());
     Base::template push<gsVisitorNonLinearElasticity<T> >(visitor);
     // Compute surface integrals and write to the global rhs vector
     // change to reuse rhs from linear system
     Base::template push<gsVisitorElasticityNeumann<T> >(m_pde_ptr->bc().neumannSides());
 
-    m_system.matrix().makeCompressed();
+    if (assembleMatrix)
+        m_system.matrix().makeCompressed();
 }
 
 template<class T>
 void gsElasticityAssembler<T>::assemble(const gsMultiPatch<T> & displacement,
-                                        const gsMultiPatch<T> & pressure)
+                                        const gsMultiPatch<T> & pressure,
+                                        bool assembleMatrix)
 {
     GISMO_ENSURE(m_options.getInt("MaterialLaw") == material_law::mixed_neo_hooke_ln,
                  "Material law not specified OR not supported!");
     m_options.setInt("MaterialLaw",material_law::mixed_neo_hooke_ln);
-    m_system.matrix().setZero();
-    reserve();
+    if (assembleMatrix)
+    {
+        m_system.matrix().setZero();
+        Base::eliminationMatrixValid = false;
+        reserve();
+    }
     m_system.rhs().setZero();
 
     // Compute volumetric integrals and write to the global linear systemz
-    gsVisitorMixedNonLinearElasticity<T> visitor(*m_pde_ptr,displacement,pressure);
+    gsVisitorMixedNonLinearElasticity<T> visitor(*m_pde_ptr,displacement,pressure,assembleMatrix,updateElementCache());
     Base::template push<gsVisitorMixedNonLinearElasticity<T> >(visitor);
     // Compute surface integrals and write to the global rhs vector
     // change to reuse rhs from linear system
     Base::template push<gsVisitorElasticityNeumann<T> >(m_pde_ptr->bc().neumannSides());
 
-    m_system.matrix().makeCompressed();
+    if (assembleMatrix)
+        m_system.matrix().makeCompressed();
+}
+
+template<class T>
+void gsElasticityAssembler<T>::applyTangent(const gsMultiPatch<T> & displacement,
+                                            const gsMatrix<T> & v, gsMatrix<T> & result)
+{
+    GISMO_ENSURE(m_bases.size() == unsigned(m_dim), "Matrix-free tangent is only available for displacement formulation");
+    GISMO_ENSURE(m_options.getInt("MaterialLaw") == material_law::saint_venant_kirchhoff ||
+                 m_options.getInt("MaterialLaw") == material_law::neo_hooke_ln ||
+                 m_options.getInt("MaterialLaw") == material_law::neo_hooke_quad,
+                 "Material law not specified OR not supported!");
+    GISMO_ENSURE(v.rows() == Base::numDofs(), "Wrong vector size!");
+    // the direction is homogeneous at the Dirichlet boundary
+    std::vector<gsMatrix<T> > zeroDDoFs(m_ddof.size());
+    for (size_t d = 0; d < m_ddof.size(); ++d)
+        zeroDDoFs[d].setZero(m_ddof[d].rows(),1);
+    // K*v is accumulated in the rhs of the system; the actual rhs is restored afterwards
+    gsMatrix<T> rhs;
+    rhs.swap(m_system.rhs());
+    result.resize(v.rows(),v.cols());
+    gsMultiPatch<T> direction;
+    gsMatrix<T> vCol;
+    for (index_t c = 0; c < v.cols(); ++c)
+    {
+        vCol = v.col(c);
+        constructSolution(vCol,zeroDDoFs,direction);
+        m_system.rhs().setZero(v.rows(),1);
+        gsVisitorNonLinearElasticity<T> visitor(*m_pde_ptr,displacement,false,updateElementCache(),&direction);
+        Base::template push<gsVisitorNonLinearElasticity<T> >(visitor);
+        result.col(c) = m_system.rhs();
+    }
+    m_system.rhs().swap(rhs);
+}
+
+template <class T>
+bool gsElasticityAssembler<T>::hasMatrixFreeTangent() const
+{
+    return m_bases.size() == unsigned(m_dim) &&
+           (m_options.getInt("MaterialLaw") == material_law::saint_venant_kirchhoff ||
+            m_options.getInt("MaterialLaw") == material_law::neo_hooke_ln ||
+            m_options.getInt("MaterialLaw") == material_law::neo_hooke_quad);
+}
+
+template <class T>
+void gsElasticityAssembler<T>::applyTangent(const gsMatrix<T> & solutionVector,
+                                            const std::vector<gsMatrix<T> > & fixedDoFs,
+                                            const gsMatrix<T> & v, gsMatrix<T> & result)
+{
+    gsMultiPatch<T> displacement;
+    constructSolution(solutionVector,fixedDoFs,displacement);
+    applyTangent(displacement,v,result);
+}
+
+template <class T>
+void gsElasticityAssembler<T>::tangentDiagonal(const gsMatrix<T> & solutionVector,
+                                               const std::vector<gsMatrix<T> > & fixedDoFs,
+                                               gsMatrix<T> & result)
+{
+    GISMO_ENSURE(hasMatrixFreeTangent(),"Matrix-free tangent is only available for displacement formulation "
+                                        "with a nonlinear material law");
+    gsMultiPatch<T> displacement;
+    constructSolution(solutionVector,fixedDoFs,displacement);
+    // the diagonal is accumulated in the rhs of the system; the actual rhs is restored afterwards
+    gsMatrix<T> rhs;
+    rhs.swap(m_system.rhs());
+    m_system.rhs().setZero(Base::numDofs(),1);
+    gsVisitorNonLinearElasticity<T> visitor(*m_pde_ptr,displacement,false,updateElementCache(),nullptr,true);
+    Base::template push<gsVisitorNonLinearElasticity<T> >(visitor);
+    result = m_system.rhs();
+    m_system.rhs().swap(rhs);
+}
+
+template <class T>
+T gsElasticityAssembler<T>::assembleSchurOperators(const gsMatrix<T> & solutionVector,
+                                                   const std::vector<gsMatrix<T> > & fixedDoFs,
+                                                   gsSparseMatrix<T> & mass,
+                                                   gsSparseMatrix<T> & laplacian,
+                                                   gsSparseMatrix<T> & convDiff)
+{
+    if (m_bases.size() == unsigned(m_dim)) // displacement formulation
+        return 0.;
+    Base::assemblePressureOperators(mass);
+    return m_options.getReal("YoungsModulus")/2./(1+m_options.getReal("PoissonsRatio"));
+}
+
+template <class T>
+const gsElementCache<T> * gsElasticityAssembler<T>::updateElementCache()
+{
+    if (!m_options.getSwitch("ElementCache"))
+        return nullptr;
+    const gsMultiBasis<T> * basisPres = m_bases.size() > unsigned(m_dim) ? &m_bases[m_dim] : nullptr;
+    if (!m_elementCache.valid(m_pde_ptr->domain(),m_bases[0],basisPres))
+        m_elementCache.compute(m_pde_ptr->domain(),m_bases[0],basisPres,
+                               m_options,size_t(m_options.getReal("ElementCacheBudget")*1048576));
+    return &m_elementCache;
 }
 
 //--------------------- SOLUTION CONSTRUCTION ----------------------------------//
@@ -18,6 +18,7 @@
 #include <gsCore/gsMultiPatch.h>
 #include <gsElasticity/gsBaseUtils.h>
 #include <gsIO/gsOptionList.h>
+#include <map>
 
 namespace gismo
 {
@@ -148,6 +149,27 @@ public:
      */
     virtual void eval_into(const gsMatrix<T> & u, gsMatrix<T> & result) const;
 
+    /// switch caching of the reference configuration data on/off
+    void setCaching(bool cachePoints) { m_cachePoints = cachePoints; clearCache(); }
+
+    /// forget all cached evaluation points
+    void clearCache() const { m_cache.clear(); m_cacheGeoSize = -1; }
+
+protected:
+    /// reference configuration data at a set of evaluation points
+    struct referenceData
+    {
+        gsMatrix<T> paramPoints; // preimages of the evaluation points in the parameter domain of the geometry patch
+        gsMatrix<T> invJacGeo;   // inverse jacobians of the geometry mapping; dim x dim*numPoints
+        gsMatrix<T> normals;     // unit outer normals; dim x numPoints
+    };
+
+    /// computes the reference configuration data by inverting the geometry mapping
+    void computeReferenceData(const gsMatrix<T> & u, referenceData & data) const;
+
+    /// returns the cached reference configuration data if available; otherwise, computes (and caches) it using *temp*
+    const referenceData & getReferenceData(const gsMatrix<T> & u, referenceData & temp) const;
+
 protected:
 
     gsMultiPatch<T> const & m_geo;
@@ -158,6 +180,12 @@ protected:
 /** @brief Loading function to transfer fluid action to the solid.
  * Used in Fluid-Structure Interaction simulation.
  * Different parametrizations can be used for the geometry+ALE and velocity+pressure
+ *
+ * Evaluation points are given in the reference configuration and have to be mapped to the parameter domain
+ * of the geometry patch. Since the reference configuration does not change, the parametric points and the reference
+ * geometry data (inverse jacobians and normals) are cached for every set of evaluation points, e.g. the quadrature points
+ * of a boundary element. The cache is invalidated if the geometry patch is refined; call clearCache() if
+ * the reference geometry is changed otherwise.
 */
 template <class T>
 class gsFsiLoad : public gsFunction<T>
@@ -167,7 +195,7 @@ public:
     gsFsiLoad(const gsMultiPatch<T> & geoRef, const gsMultiPatch<T> & ALEdisplacement,
               index_t patchGeo, boxSide sideGeo,
               const gsMultiPatch<T> & velocity, const gsMultiPatch<T> & pressure,
-              index_t patchVelPres, T viscosity, T density)
+              index_t patchVelPres, T viscosity, T density, bool cachePoints = true)
         : m_geo(geoRef),
           m_ale(ALEdisplacement),
           m_patchGeo(patchGeo),
@@ -176,7 +204,9 @@ public:
           m_pres(pressure),
           m_patchVP(patchVelPres),
           m_viscosity(viscosity),
-          m_density(density)
+          m_density(density),
+          m_cachePoints(cachePoints),
+          m_cacheGeoSize(-1)
     {}
 
     virtual short_t domainDim() const { return m_geo.domainDim(); }
@@ -199,6 +229,11 @@ protected:
     index_t m_patchVP;
     T m_viscosity;
     T m_density;
+    /// cache of the reference configuration data; the key are the coordinates of the evaluation points
+    bool m_cachePoints;
+    mutable std::map<std::vector<T>,referenceData> m_cache;
+    /// number of control points of the geometry patch when the cache was filled; detects refinement
+    mutable index_t m_cacheGeoSize;
 
 }; // class definition ends
 
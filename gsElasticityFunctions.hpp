@@ -241,35 +241,32 @@ template <class T>
 void gsFsiLoad<T>::eval_into(const gsMatrix<T> & u, gsMatrix<T> & result) const
 {
     result.setZero(targetDim(),u.cols());
+    const short_t dim = targetDim();
     // mapping points back to the parameter space via the reference configuration
-    gsMatrix<T> paramPoints;
-    m_geo.patch(m_patchGeo).invertPoints(u,paramPoints);
-    // evaluate reference geometry mapping at the param points
-    // NEED_GRAD_TRANSFORM for velocity gradients transformation from parametric to reference domain
-    gsMapData<T> mdGeo(NEED_GRAD_TRANSFORM);
-    mdGeo.points = paramPoints;
-    m_geo.patch(m_patchGeo).computeMap(mdGeo);
+    referenceData temp;
+    const referenceData & ref = getReferenceData(u,temp);
     // evaluate velocity at the param points
     // NEED_DERIV for velocity gradients
     gsMapData<T> mdVel(NEED_DERIV);
-    mdVel.points = paramPoints;
+    mdVel.points = ref.paramPoints;
     m_vel.patch(m_patchVP).computeMap(mdVel);
     // evaluate pressure at the quad points
     gsMatrix<T> pressureValues;
-    m_pres.patch(m_patchVP).eval_into(paramPoints,pressureValues);
+    m_pres.patch(m_patchVP).eval_into(ref.paramPoints,pressureValues);
     // evaluate ALE dispacement at the param points
     // NEED_DERIV for gradients
     gsMapData<T> mdALE(NEED_DERIV);
-    mdALE.points = paramPoints;
+    mdALE.points = ref.paramPoints;
     m_ale.patch(m_patchGeo).computeMap(mdALE);
 
-    gsMatrix<T> I  = gsMatrix<T>::Identity(targetDim(),targetDim());
-    for (index_t p = 0; p < paramPoints.cols(); ++p)
+    gsMatrix<T> I  = gsMatrix<T>::Identity(dim,dim);
+    for (index_t p = 0; p < ref.paramPoints.cols(); ++p)
     {
+        const gsMatrix<T> invJacGeo = ref.invJacGeo.block(0,p*dim,dim,dim);
         // transform velocity gradients from parametric to reference
-        gsMatrix<T> physGradVel = mdVel.jacobian(p)*(mdGeo.jacobian(p).cramerInverse());
+        gsMatrix<T> physGradVel = mdVel.jacobian(p)*invJacGeo;
         // ALE jacobian (identity + physical displacement gradient)
-        gsMatrix<T> physJacALE = I + mdALE.jacobian(p)*(mdGeo.jacobian(p).cramerInverse());
+        gsMatrix<T> physJacALE = I + mdALE.jacobian(p)*invJacGeo;
         // inverse ALE jacobian
         gsMatrix<T> invJacALE = physJacALE.cramerInverse();
         // ALE stress tensor
@@ -279,11 +276,65 @@ void gsFsiLoad<T>::eval_into(const gsMatrix<T> & u, gsMatrix<T> & result) const
         // stress tensor pull back
         gsMatrix<T> sigmaALE = physJacALE.determinant()*sigma*(invJacALE.transpose());
 
+        result.col(p) = sigmaALE * ref.normals.col(p);
+    }
+}
+
+template <class T>
+void gsFsiLoad<T>::computeReferenceData(const gsMatrix<T> & u, referenceData & data) const
+{
+    const short_t dim = targetDim();
+    m_geo.patch(m_patchGeo).invertPoints(u,data.paramPoints);
+    // evaluate reference geometry mapping at the param points
+    // NEED_GRAD_TRANSFORM for velocity gradients transformation from parametric to reference domain
+    gsMapData<T> mdGeo(NEED_GRAD_TRANSFORM);
+    mdGeo.points = data.paramPoints;
+    m_geo.patch(m_patchGeo).computeMap(mdGeo);
+
+    data.invJacGeo.resize(dim,dim*u.cols());
+    data.normals.resize(dim,u.cols());
+    gsVector<T> normal;
+    for (index_t p = 0; p < u.cols(); ++p)
+    {
+        data.invJacGeo.block(0,p*dim,dim,dim) = mdGeo.jacobian(p).cramerInverse();
         // normal length is the local measure
-        gsVector<T> normal;
         outerNormal(mdGeo,p,m_sideGeo,normal);
-        result.col(p) = sigmaALE * normal / normal.norm();
+        data.normals.col(p) = normal / normal.norm();
+    }
+}
+
+template <class T>
+const typename gsFsiLoad<T>::referenceData & gsFsiLoad<T>::getReferenceData(const gsMatrix<T> & u, referenceData & temp) const
+{
+    if (!m_cachePoints)
+    {
+        computeReferenceData(u,temp);
+        return temp;
     }
+
+    const std::vector<T> key(u.data(),u.data()+u.size());
+    const referenceData * cached = nullptr;
+    // the function can be evaluated by several threads during assembly
+#pragma omp critical (gsFsiLoadCache)
+    {
+        // refinement of the geometry patch invalidates the cache
+        if (m_cacheGeoSize != m_geo.patch(m_patchGeo).coefs().rows())
+        {
+            m_cache.clear();
+            m_cacheGeoSize = m_geo.patch(m_patchGeo).coefs().rows();
+        }
+        typename std::map<std::vector<T>,referenceData>::const_iterator it = m_cache.find(key);
+        if (it != m_cache.end())
+            cached = &(it->second);
+    }
+    if (cached != nullptr)
+        return *cached;
+
+    computeReferenceData(u,temp);
+    // insert does not overwrite the entry if another thread has stored it meanwhile; that entry may already be in use
+#pragma omp critical (gsFsiLoadCache)
+    cached = &(m_cache.insert(std::make_pair(key,temp)).first->second);
+    return *cached;
 }
 
 } // namespace gismo ends
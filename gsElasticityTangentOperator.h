@@ -0,0 +1,67 @@
+/** @file gsElasticityTangentOperator.h
+
+    @brief Matrix-free tangential operator of nonlinear elasticity.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsSolver/gsLinearOperator.h>
+#include <gsElasticity/gsBaseAssembler.h>
+
+namespace gismo
+{
+
+/** @brief Applies the tangential matrix of a nonlinear problem without assembling it,
+ * see gsBaseAssembler::applyTangent and gsElasticityAssembler::applyTangent. Memory only scales with the number
+ * of degrees of freedom, which allows to use Krylov solvers for discretizations whose tangential matrix
+ * does not fit into memory. Used by the matrix-free Newton's method of gsIterative (option MatrixFree).
+*/
+template <class T>
+class gsElasticityTangentOperator : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsElasticityTangentOperator> Ptr;
+    typedef memory::unique_ptr<gsElasticityTangentOperator> uPtr;
+
+    gsElasticityTangentOperator(gsBaseAssembler<T> & assembler)
+        : m_assembler(assembler)
+    { GISMO_ENSURE(assembler.hasMatrixFreeTangent(),"The assembler does not provide a matrix-free tangent"); }
+
+    static uPtr make(gsBaseAssembler<T> & assembler)
+    { return uPtr(new gsElasticityTangentOperator(assembler)); }
+
+    /// set the solution at which the tangent is evaluated from the solution vector and fixed DoFs
+    void setDisplacement(const gsMatrix<T> & solutionVector, const std::vector<gsMatrix<T> > & fixedDoFs)
+    {
+        m_solVector = solutionVector;
+        m_fixedDoFs = fixedDoFs;
+    }
+
+    /// x = K*input
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    { m_assembler.applyTangent(m_solVector,m_fixedDoFs,input,x); }
+
+    /// diagonal of K, e.g. for a Jacobi preconditioner
+    void diagonal(gsMatrix<T> & result) const
+    { m_assembler.tangentDiagonal(m_solVector,m_fixedDoFs,result); }
+
+    virtual index_t rows() const { return m_assembler.numDofs(); }
+
+    virtual index_t cols() const { return m_assembler.numDofs(); }
+
+protected:
+    gsBaseAssembler<T> & m_assembler;
+    gsMatrix<T> m_solVector;
+    std::vector<gsMatrix<T> > m_fixedDoFs;
+};
+
+} // namespace ends
@@ -0,0 +1,107 @@
+/** @file gsElementCache.h
+
+    @brief Stores geometry and basis evaluations at quadrature points of all elements.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsMultiPatch.h>
+#include <gsCore/gsMultiBasis.h>
+
+namespace gismo
+{
+
+/** @brief Caches the element data which does not change between Newton's iterations and time steps:
+ * images of quadrature points, geometry jacobians and measures, active functions, values and physical gradients
+ * of the displacement basis and values of the pressure basis (if any).
+ *
+ * Visitors look up elements by the first quadrature node, so the cache works with any element loop.
+ * The cache is tied to the domain and the bases it was computed for and becomes invalid if their sizes change;
+ * if the domain is moved without changing its size (e.g., by ALE), call invalidate().
+ * Elements are only cached as long as the memory budget allows; the remaining elements are evaluated as usual.
+*/
+template <class T>
+class gsElementCache
+{
+public:
+    /// data of a single element; matrices for all quadrature points are stacked horizontally
+    struct Element
+    {
+        gsMatrix<T> points;         // images of quadrature points, dim x N_Q
+        gsVector<T> measures;       // geometry measures at quadrature points
+        gsMatrix<T> jacobians;      // geometry jacobians, dim x dim*N_Q
+        gsMatrix<T> jacobiansInv;   // inverse geometry jacobians, dim x dim*N_Q
+        gsMatrix<index_t> activesDisp;
+        gsMatrix<T> valuesDisp;     // values of displacement basis functions, N_D x N_Q
+        gsMatrix<T> physGradsDisp;  // physical gradients of displacement basis functions, dim x N_D*N_Q
+        gsMatrix<index_t> activesPres;
+        gsMatrix<T> valuesPres;     // values of pressure basis functions, N_P x N_Q
+
+        size_t memory() const;
+    };
+
+    gsElementCache() { invalidate(); }
+
+    /// @brief Computes the cache for a given domain and bases using the quadrature rule defined by *options*.
+    /// Stops caching new elements once *budget* bytes are used
+    void compute(const gsMultiPatch<T> & domain,
+                 const gsMultiBasis<T> & basisDisp,
+                 const gsMultiBasis<T> * basisPres,
+                 const gsOptionList & options,
+                 size_t budget);
+
+    /// returns true if the cache was computed for the given domain and bases (including the pressure basis, if any)
+    /// and they did not change the size since
+    bool valid(const gsMultiPatch<T> & domain, const gsMultiBasis<T> & basisDisp,
+               const gsMultiBasis<T> * basisPres) const;
+
+    /// forget all cached data
+    void invalidate();
+
+    /// returns the cached element with a given first quadrature node or nullptr if the element is not cached
+    const Element * find(index_t patch, const gsMatrix<T> & quNodes) const;
+
+    /// memory used by the cached data in bytes
+    size_t memory() const { return m_memory; }
+
+    /// number of cached elements
+    index_t numCached() const { return m_numCached; }
+
+    /// total number of elements in the domain
+    index_t numElements() const { return m_numElements; }
+
+    /// returns a string with the cache footprint
+    std::string status() const;
+
+protected:
+    typedef std::map<std::vector<T>,index_t> elementMap;
+
+    // cached element data and the lookup tables, one per patch
+    std::vector<std::vector<Element> > m_elements;
+    std::vector<elementMap> m_maps;
+    // identity of the domain and the basis the cache was computed for
+    const gsMultiPatch<T> * m_domain;
+    const gsMultiBasis<T> * m_basis;
+    const gsMultiBasis<T> * m_basisPres;
+    std::vector<index_t> m_basisSizes;
+    std::vector<index_t> m_basisPresSizes;
+    // statistics
+    size_t m_memory;
+    index_t m_numCached;
+    index_t m_numElements;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsElementCache.hpp)
+#endif
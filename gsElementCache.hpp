@@ -0,0 +1,170 @@
+/** @file gsElementCache.hpp
+
+    @brief Implementation of gsElementCache.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsElementCache.h>
+
+#include <gsAssembler/gsQuadrature.h>
+#include <gsCore/gsFuncData.h>
+
+namespace gismo
+{
+
+template <class T>
+size_t gsElementCache<T>::Element::memory() const
+{
+    return sizeof(T)*(points.size() + measures.size() + jacobians.size() + jacobiansInv.size() +
+                      valuesDisp.size() + physGradsDisp.size() + valuesPres.size()) +
+           sizeof(index_t)*(activesDisp.size() + activesPres.size());
+}
+
+template <class T>
+void gsElementCache<T>::invalidate()
+{
+    m_elements.clear();
+    m_maps.clear();
+    m_domain = nullptr;
+    m_basis = nullptr;
+    m_basisPres = nullptr;
+    m_basisSizes.clear();
+    m_basisPresSizes.clear();
+    m_memory = 0;
+    m_numCached = 0;
+    m_numElements = 0;
+}
+
+template <class T>
+bool gsElementCache<T>::valid(const gsMultiPatch<T> & domain, const gsMultiBasis<T> & basisDisp,
+                              const gsMultiBasis<T> * basisPres) const
+{
+    if (m_domain != &domain || m_basis != &basisDisp || m_basisSizes.size() != basisDisp.nBases())
+        return false;
+    for (size_t p = 0; p < basisDisp.nBases(); ++p)
+        if (m_basisSizes[p] != basisDisp[p].size())
+            return false;
+    // the pressure basis can be refined independently in mixed formulations
+    if (m_basisPres != basisPres)
+        return false;
+    if (basisPres != nullptr)
+    {
+        if (m_basisPresSizes.size() != basisPres->nBases())
+            return false;
+        for (size_t p = 0; p < basisPres->nBases(); ++p)
+            if (m_basisPresSizes[p] != (*basisPres)[p].size())
+                return false;
+    }
+    return true;
+}
+
+template <class T>
+void gsElementCache<T>::compute(const gsMultiPatch<T> & domain,
+                                const gsMultiBasis<T> & basisDisp,
+                                const gsMultiBasis<T> * basisPres,
+                                const gsOptionList & options,
+                                size_t budget)
+{
+    invalidate();
+    m_domain = &domain;
+    m_basis = &basisDisp;
+    m_basisPres = basisPres;
+    m_elements.resize(domain.nPatches());
+    m_maps.resize(domain.nPatches());
+
+    gsQuadRule<T> quRule;
+    gsMatrix<T> quNodes;
+    gsVector<T> quWeights;
+    gsMapData<T> md;
+    md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
+    std::vector<gsMatrix<T> > basisValuesDisp;
+    gsMatrix<T> physGrad;
+    bool full = false;
+
+    for (size_t p = 0; p < domain.nPatches(); ++p)
+    {
+        m_basisSizes.push_back(basisDisp[p].size());
+        if (basisPres != nullptr)
+            m_basisPresSizes.push_back((*basisPres)[p].size());
+        m_numElements += basisDisp[p].numElements();
+        quRule = gsQuadrature::get(basisDisp[p],options);
+        typename gsBasis<T>::domainIter domIt = basisDisp[p].makeDomainIterator(boundary::none);
+        for (; domIt->good() && !full; domIt->next())
+        {
+            quRule.mapTo(domIt->lowerCorner(),domIt->upperCorner(),quNodes,quWeights);
+            const index_t N_Q = quNodes.cols();
+            const short_t dim = quNodes.rows();
+            Element el;
+            // geometry
+            md.points = quNodes;
+            domain.patch(p).computeMap(md);
+            el.points = md.values[0];
+            el.measures.resize(N_Q);
+            el.jacobians.resize(dim,dim*N_Q);
+            el.jacobiansInv.resize(dim,dim*N_Q);
+            for (index_t q = 0; q < N_Q; ++q)
+            {
+                el.measures(q) = md.measure(q);
+                el.jacobians.middleCols(q*dim,dim) = md.jacobian(q);
+                el.jacobiansInv.middleCols(q*dim,dim) = md.jacobian(q).cramerInverse();
+            }
+            // displacement basis
+            basisDisp[p].active_into(quNodes.col(0),el.activesDisp);
+            basisDisp[p].evalAllDers_into(quNodes,1,basisValuesDisp);
+            const index_t N_D = el.activesDisp.rows();
+            el.valuesDisp = basisValuesDisp[0];
+            el.physGradsDisp.resize(dim,N_D*N_Q);
+            for (index_t q = 0; q < N_Q; ++q)
+            {
+                transformGradients(md,q,basisValuesDisp[1],physGrad);
+                el.physGradsDisp.middleCols(q*N_D,N_D) = physGrad;
+            }
+            // pressure basis
+            if (basisPres != nullptr)
+            {
+                (*basisPres)[p].active_into(quNodes.col(0),el.activesPres);
+                (*basisPres)[p].eval_into(quNodes,el.valuesPres);
+            }
+
+            if (m_memory + el.memory() > budget)
+                full = true;
+            else
+            {
+                m_memory += el.memory();
+                std::vector<T> key(quNodes.col(0).data(),quNodes.col(0).data()+dim);
+                m_maps[p][key] = m_elements[p].size();
+                m_elements[p].push_back(el);
+                ++m_numCached;
+            }
+        }
+    }
+}
+
+template <class T>
+const typename gsElementCache<T>::Element * gsElementCache<T>::find(index_t patch, const gsMatrix<T> & quNodes) const
+{
+    if (patch >= index_t(m_maps.size()))
+        return nullptr;
+    std::vector<T> key(quNodes.col(0).data(),quNodes.col(0).data()+quNodes.rows());
+    typename elementMap::const_iterator it = m_maps[patch].find(key);
+    return it == m_maps[patch].end() ? nullptr : &m_elements[patch][it->second];
+}
+
+template <class T>
+std::string gsElementCache<T>::status() const
+{
+    return "Element cache: " + util::to_string(m_numCached) + "/" + util::to_string(m_numElements) +
+           " elements, " + util::to_string(m_memory/1048576.) + " MB";
+}
+
+} // namespace ends
@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsElementCache.h>
+#include <gsElasticity/gsElementCache.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsElementCache<real_t>;
+}
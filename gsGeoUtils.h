@@ -15,6 +15,7 @@
 #pragma once
 
 #include <gsCore/gsMultiPatch.h>
+#include <gsElasticity/gsBaseUtils.h>
 
 namespace gismo
 {
@@ -35,10 +36,13 @@ void plotGeometry(const gsMultiPatch<T> & domain, std::string const & fileName,
                   gsParaviewCollection & collection, index_t step);
 
 /// use all saved displacement fields to plot the all intermediate deformed configurations of the computational domain;
-/// always plots the deformed isoparametric mesh; plots the Jacobian determinant of the deformed configuration if *numSamplingPoints* > 0
+/// always plots the deformed isoparametric mesh; plots the Jacobian determinant of the deformed configuration if *numSamplingPoints* > 0;
+/// *format* and *precision* specify the data arrays of the Jacobian files, see gsWriteParaviewMultiPhysics
 template <class T>
 void plotDeformation(const gsMultiPatch<T> & initDomain, const std::vector<gsMultiPatch<T> > & displacements,
-                     std::string fileName, index_t numSamplingPoints = 10000);
+                     std::string fileName, index_t numSamplingPoints = 10000,
+                     paraview_format::format format = paraview_format::ascii,
+                     paraview_precision::precision precision = paraview_precision::float32);
 
 /// plot a deformed isogeometric mesh and add it to a Paraview collection
 template <class T>
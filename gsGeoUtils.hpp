@@ -92,7 +92,8 @@ void plotGeometry(const gsMultiPatch<T> & domain, std::string const & fileName,
 
 template <class T>
 void plotDeformation(const gsMultiPatch<T> & initDomain, const std::vector<gsMultiPatch<T> > & displacements,
-                                             std::string fileName, index_t numSamplingPoints)
+                                             std::string fileName, index_t numSamplingPoints,
+                                             paraview_format::format format, paraview_precision::precision precision)
 {
     gsInfo << "Plotting deformed configurations...\n";
 
@@ -119,7 +120,7 @@ void plotDeformation(const gsMultiPatch<T> & initDomain, const std::vector<gsMul
     gsField<T> detField(configuration,dets,true);
     std::map<std::string,const gsField<T> *> fields;
     fields["Jacobian"] = &detField;
-    gsWriteParaviewMultiPhysics(fields,fileName+std::to_string(0),numSamplingPoints == 0 ? 1 : numSamplingPoints,true);
+    gsWriteParaviewMultiPhysics(fields,fileName+std::to_string(0),numSamplingPoints == 0 ? 1 : numSamplingPoints,true,false,format,precision);
 
     for (size_t p = 0; p < configuration.nPatches(); ++p)
     {
@@ -147,7 +148,7 @@ void plotDeformation(const gsMultiPatch<T> & initDomain, const std::vector<gsMul
                configuration.patch(p).coefs() -= displacements[s-1].patch(p).coefs();
         }
 
-        gsWriteParaviewMultiPhysics(fields,fileName+std::to_string(s+1),numSamplingPoints == 0 ? 1 : numSamplingPoints,true);
+        gsWriteParaviewMultiPhysics(fields,fileName+std::to_string(s+1),numSamplingPoints == 0 ? 1 : numSamplingPoints,true,false,format,precision);
         for (size_t p = 0; p < configuration.nPatches(); ++p)
         {
             collectionMesh.addTimestep(fileNameOnly + std::to_string(s+1),p,s+1,"_mesh.vtp");
@@ -16,7 +16,8 @@ TEMPLATE_INST void plotGeometry(const gsMultiPatch<real_t> & domain,std::string
                                 gsParaviewCollection & collection, index_t step);
 
 TEMPLATE_INST void plotDeformation(const gsMultiPatch<real_t> & initDomain, const std::vector<gsMultiPatch<real_t> > & displacements,
-                     std::string fileName, index_t numSamplingPoints);
+                     std::string fileName, index_t numSamplingPoints,
+                     paraview_format::format format, paraview_precision::precision precision);
 
 TEMPLATE_INST void plotDeformation(const gsMultiPatch<real_t> & initDomain, const gsMultiPatch<real_t> & displacement,
                                    std::string const & fileName, gsParaviewCollection & collection, index_t step);
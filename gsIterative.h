@@ -17,6 +17,7 @@
 
 #include <gsIO/gsOptionList.h>
 #include <gsElasticity/gsBaseUtils.h>
+#include <gsElasticity/gsLinearSolverCache.h>
 #include <functional>
 
 namespace gismo
@@ -24,6 +25,8 @@ namespace gismo
 
 template <class T>
 class gsBaseAssembler;
+template <class T>
+class gsElasticityTangentOperator;
 // TODO correct
 /** @brief A general iterative solver for nonlinear problems.
  * An equation to solve is specified by an assembler class which
@@ -33,6 +36,8 @@ class gsBaseAssembler;
  * const gsSparseMatrix<T> & matrix() const;
  * const gsMatrix<T> & rhs() const;
  * void assemble(const gsMatrix<T> & solutionVector);
+ * void assembleResidual(const gsMatrix<T> & solutionVector); // only for the modified Newton's method and line search
+ * void applyTangent(...); void tangentDiagonal(...); // only for the matrix-free Newton's method (option MatrixFree)
  * options().setReal("DirichletScaling",T);
  * options().setReal("ForceScaling",T);
  * .
@@ -83,6 +88,12 @@ public:
     /// return solver status as a string
     std::string status();
 
+    /// return solver status
+    solver_status solverStatus() const { return m_status; }
+
+    /// returns the linear solver, e.g. to query the Krylov iteration counts and timings
+    const gsLinearSolverCache<T> & linearSolver() const { return linSolver; }
+
     /// reset the solver state
     void reset();
 
@@ -92,6 +103,9 @@ public:
     /// number of iteration that Newton's method took
     index_t numberIterations() const {return numIterations;}
 
+    /// number of Jacobian assemblies and factorizations Newton's method took
+    index_t numberJacobians() const {return numJacobians;}
+
     /// set initial guess
     void setSolutionVector(const gsMatrix<T> & solutionVector) { solVector = solutionVector; }
 
@@ -101,6 +115,37 @@ public:
     /// recover solver state from saved state
     void recoverState();
 
+protected:
+    /// decides whether the Jacobian must be assembled and factorized at the current iteration
+    bool updateJacobian() const;
+
+    /// finds a step length for the update vector according to the line search option;
+    /// steps leading to an invalid configuration are shrunk; returns 0 if no valid step was found
+    T lineSearch(const gsVector<T> & update);
+
+    /// step length iterations of lineSearch() given the residual norm and the directional derivative at step 0
+    T lineSearchStep(const gsVector<T> & update, T resNorm0, T dirDeriv0);
+
+    /// evaluates the residual (rhs of the assembler) at solVector + step*update; a pending Dirichlet increment
+    /// is scaled by step as well; returns false if the configuration is invalid
+    bool trialResidual(const gsVector<T> & update, T step);
+
+    /// matrix-free Newton's method: assembles the residual and solves with the matrix-free tangent
+    /// of the assembler and a Krylov method; returns false if the configuration is invalid
+    bool solveMatrixFree(gsVector<T> & update);
+
+    template <class Solver>
+    void solveKrylov(Solver & solver, const gsMatrix<T> & rhs, gsMatrix<T> & x)
+    {
+        solver.setTolerance(m_options.getReal("LinearTol"));
+        solver.setMaxIterations(m_options.getInt("LinearMaxIters"));
+        solver.solve(rhs,x);
+        mfIterations = solver.iterations();
+    }
+
+    /// passes the pressure operators of the current solution to the block-triangular preconditioner
+    void updateSchurOperators();
+
 protected:
     /// assembler object that generates the linear system
     gsBaseAssembler<T> & assembler;
@@ -115,11 +160,26 @@ protected:
     T initResidualNorm; /// norm of the residual vector at the beginning of the loop
     T updateNorm; /// norm of the update vector
     T initUpdateNorm; /// norm of the update vector at the beginning of the loop
+    T oldResidualNorm; /// norm of the residual vector at the previous iteration
+    index_t numJacobians; /// number of Jacobian updates performed
+    index_t lastJacobianIter; /// iteration at which the Jacobian was updated last
+    T stepLength; /// step length chosen by the line search at the last iteration
+    bool dirichletPending; /// the Dirichlet increment held by the assembler is not fully applied yet (update type)
     /// option list
     gsOptionList m_options;
+    /// linear solver; keeps the symbolic factorization between iterations
+    gsLinearSolverCache<T> linSolver;
 
     gsMatrix<T> solVecSaved;
     std::vector<gsMatrix<T> > ddofsSaved;
+    /// temporary objects for the line search
+    gsMatrix<T> trialSolVector;
+    std::vector<gsMatrix<T> > trialFixedDoFs;
+    std::vector<gsMatrix<T> > trialDdofs;
+    gsSparseMatrix<T> savedMatrix;
+    /// matrix-free tangent and the number of Krylov iterations at the last iteration
+    memory::shared_ptr<gsElasticityTangentOperator<T> > tangentOp;
+    index_t mfIterations;
 };
 
 } // namespace ends
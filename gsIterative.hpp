@@ -18,6 +18,12 @@
 #include <gsElasticity/gsIterative.h>
 
 #include <gsElasticity/gsBaseAssembler.h>
+#include <gsElasticity/gsElasticityTangentOperator.h>
+#include <gsElasticity/gsElPreconditioners.h>
+
+#include <gsSolver/gsConjugateGradient.h>
+#include <gsSolver/gsMinimalResidual.h>
+#include <gsSolver/gsGMRes.h>
 
 #include <sstream>
 
@@ -69,6 +75,12 @@ void gsIterative<T>::reset()
     initResidualNorm = 1.;
     updateNorm = 0.;
     initUpdateNorm = 1.;
+    oldResidualNorm = 0.;
+    numJacobians = 0;
+    lastJacobianIter = 0;
+    stepLength = 1.;
+    dirichletPending = true;
+    mfIterations = 0;
 }
 
 template <class T>
@@ -77,6 +89,12 @@ gsOptionList gsIterative<T>::defaultOptions()
     gsOptionList opt;
     /// linear solver
     opt.addInt("Solver","Linear solver to use",linear_solver::LU);
+    opt.addInt("Precond","Preconditioner for the Krylov solvers: none, jacobi, ILUT, IC0, block_jacobi, AMG; ILUT is replaced by jacobi with MINRES",linear_precond::ILUT);
+    opt.addReal("LinearTol","Relative residual tolerance of the Krylov solvers",1e-8);
+    opt.addInt("LinearMaxIters","Maximum number of iterations of the Krylov solvers",1000);
+    opt.addReal("PrecondRefresh","Reuse the preconditioner across iterations until the Krylov iterations grow by this factor; 0 - never reuse",2.);
+    opt.addInt("SchurApprox","Schur complement approximation of the block-triangular preconditioner: mass, PCD, LSC",schur_approx::mass);
+    opt.addInt("VelocityPrecond","Preconditioner for the velocity/displacement block of the block-triangular preconditioner",linear_precond::AMG);
     /// stopping creteria
     opt.addInt("MaxIters","Maximum number of iterations per loop",50);
     opt.addReal("AbsTol","Absolute tolerance for the convergence cretiria",1e-12);
@@ -84,6 +102,21 @@ gsOptionList gsIterative<T>::defaultOptions()
     /// additional setting
     opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all",solver_verbosity::none);
     opt.addInt("IterType","Type of iteration: update or next/full",iteration_type::update);
+    /// modified Newton's method
+    opt.addInt("JacobianUpdate","When to update the Jacobian: always, every k iterations, on stagnation",jacobian_update::always);
+    opt.addInt("JacobianUpdateFreq","Number of iterations k between Jacobian updates",3);
+    opt.addReal("StagnationRatio","Update the Jacobian if the residual is reduced by less than this factor",0.5);
+    /// line search
+    opt.addInt("LineSearch","Step length control: none, backtracking, secant",line_search::none);
+    opt.addInt("LineSearchMaxIters","Maximum number of step length reductions per iteration",10);
+    opt.addReal("LineSearchShrink","Factor by which the step length is reduced",0.5);
+    opt.addReal("LineSearchArmijo","Sufficient decrease parameter for backtracking",1e-4);
+    opt.addReal("LineSearchTol","Tolerance for the secant line search: |du*r(s)| < tol*|du*r(0)|",0.5);
+    opt.addReal("LineSearchMinStep","Minimal step length",1e-3);
+    /// matrix-free Newton's method
+    opt.addSwitch("MatrixFree","Solve with the matrix-free tangent of the assembler instead of assembling it; "
+                               "uses GMRES (or CG, MINRES if chosen as Solver) with the assembled diagonal as a preconditioner "
+                               "unless Precond is none",false);
     return opt;
 }
 
@@ -99,10 +132,13 @@ void gsIterative<T>::solve()
         }
         if (m_options.getInt("Verbosity") == solver_verbosity::all)
             gsInfo << status() << std::endl;
-        if (residualNorm < m_options.getReal("AbsTol") ||
-            updateNorm < m_options.getReal("AbsTol") ||
-            residualNorm/initResidualNorm < m_options.getReal("RelTol") ||
-            updateNorm/initUpdateNorm < m_options.getReal("RelTol"))
+        // a Dirichlet increment shortened by the line search has to be applied completely first
+        const bool dirichletApplied = !dirichletPending || stepLength == 1.;
+        if (dirichletApplied &&
+            (residualNorm < m_options.getReal("AbsTol") ||
+             updateNorm < m_options.getReal("AbsTol") ||
+             residualNorm/initResidualNorm < m_options.getReal("RelTol") ||
+             updateNorm/initUpdateNorm < m_options.getReal("RelTol")))
             m_status = solver_status::converged;
         else if (numIterations == m_options.getInt("MaxIters"))
             m_status = solver_status::interrupted;
@@ -116,54 +152,84 @@ void gsIterative<T>::solve()
 template <class T>
 bool gsIterative<T>::compute()
 {
-    // update mode: set Dirichlet BC to zero after the first iteration
-    if (numIterations == 1 && m_options.getInt("IterType") == iteration_type::update)
-        assembler.homogenizeFixedDofs(-1);
-
-    if (!assembler.assemble(solVector,fixedDoFs))
-        return false;
-
-    gsVector<T> solutionVector;
-    if (m_options.getInt("Solver") == linear_solver::LU)
-    {
-#ifdef GISMO_WITH_PARDISO
-        gsSparseSolver<>::PardisoLU solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
-#else
-        gsSparseSolver<>::LU solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
-#endif
-    }
-    if (m_options.getInt("Solver") == linear_solver::LDLT)
+    // update mode: set Dirichlet BC to zero once their increment is applied; if the line search
+    // has shortened the previous step, the remaining part of the increment is applied at this iteration
+    if (numIterations > 0 && dirichletPending && m_options.getInt("IterType") == iteration_type::update)
     {
-#ifdef GISMO_WITH_PARDISO
-        gsSparseSolver<>::PardisoLDLT solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
-#else
-        gsSparseSolver<>::SimplicialLDLT solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
-#endif
+        if (stepLength < 1.)
+        {
+            std::vector<gsMatrix<T> > ddofs = assembler.allFixedDofs();
+            for (index_t d = 0; d < (index_t)(ddofs.size()); ++d)
+                ddofs[d] *= 1. - stepLength;
+            assembler.setFixedDofs(ddofs);
+        }
+        else
+        {
+            assembler.homogenizeFixedDofs(-1);
+            dirichletPending = false;
+        }
     }
-    if (m_options.getInt("Solver") == linear_solver::BiCGSTABDiagonal)
+
+    gsVector<T> solutionVector;
+    if (m_options.getSwitch("MatrixFree"))
     {
-        gsSparseSolver<>::BiCGSTABDiagonal solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
+        if (!solveMatrixFree(solutionVector))
+            return false;
     }
-    if (m_options.getInt("Solver") == linear_solver::CGDiagonal)
+    else
     {
-        gsSparseSolver<>::CGDiagonal solver(assembler.matrix());
-        solutionVector = solver.solve(assembler.rhs());
+        linSolver.setSolver(m_options.getInt("Solver"));
+        if (linSolver.krylov())
+        {
+            linSolver.setPreconditioner(m_options.getInt("Precond"));
+            linSolver.setTolerance(m_options.getReal("LinearTol"));
+            linSolver.setMaxIterations(m_options.getInt("LinearMaxIters"));
+            linSolver.setPrecondRefresh(m_options.getReal("PrecondRefresh"));
+            // one diagonal block per unknown, e.g. per displacement component
+            std::vector<index_t> blockSizes = assembler.freeBlockSizes();
+            index_t totalSize = 0;
+            for (size_t b = 0; b < blockSizes.size(); ++b)
+                totalSize += blockSizes[b];
+            if (totalSize != assembler.numDofs())
+                blockSizes.assign(1,assembler.numDofs());
+            linSolver.setBlockSizes(blockSizes);
+        }
+        if (updateJacobian())
+        {
+            if (!assembler.assemble(solVector,fixedDoFs))
+                return false;
+            if (linSolver.krylov() && m_options.getInt("Precond") == linear_precond::block_triangular)
+                updateSchurOperators();
+            // symbolic analysis is reused as long as the sparsity pattern stays the same
+            linSolver.factorize(assembler.matrix());
+            lastJacobianIter = numIterations;
+            numJacobians++;
+        }
+        else // modified Newton's method: reuse the old factorization and only compute the residual
+            if (!assembler.assembleResidual(solVector,fixedDoFs))
+                return false;
+
+        solutionVector = linSolver.solve(assembler.rhs());
     }
 
     if (m_options.getInt("IterType") == iteration_type::update)
     {
-        updateNorm = solutionVector.norm();
+        oldResidualNorm = residualNorm;
         residualNorm = assembler.rhs().norm();
+        stepLength = 1.;
+        if (m_options.getInt("LineSearch") != line_search::none)
+        {
+            stepLength = lineSearch(solutionVector);
+            if (stepLength == 0.)
+                return false;
+            solutionVector *= stepLength;
+        }
+        updateNorm = solutionVector.norm();
         solVector += solutionVector;
-        // update fixed degrees fo freedom at the first iteration only (they are zero afterwards)
-        if (numIterations == 0)
+        // update fixed degrees fo freedom while their increment is pending (they are zero afterwards)
+        if (dirichletPending)
             for (index_t d = 0; d < (index_t)(fixedDoFs.size()); ++d)
-                fixedDoFs[d] += assembler.fixedDofs(d);
+                fixedDoFs[d] += stepLength*assembler.fixedDofs(d);
     }
     else if (m_options.getInt("IterType") == iteration_type::next)
     {
@@ -185,6 +251,179 @@ bool gsIterative<T>::compute()
     return true;
 }
 
+template <class T>
+bool gsIterative<T>::solveMatrixFree(gsVector<T> & update)
+{
+    GISMO_ENSURE(m_options.getInt("IterType") == iteration_type::update,
+                 "The matrix-free Newton's method requires the update iteration type");
+    GISMO_ENSURE(assembler.hasMatrixFreeTangent() && assembler.hasResidualAssembly(),
+                 "The assembler provides no matrix-free tangent");
+    // the residual-only assembly does not eliminate Dirichlet DoFs;
+    // instead, their values are applied in full before the first iteration
+    if (numIterations == 0)
+    {
+        for (index_t d = 0; d < (index_t)(fixedDoFs.size()); ++d)
+            fixedDoFs[d] += assembler.fixedDofs(d);
+        assembler.homogenizeFixedDofs(-1);
+        dirichletPending = false;
+    }
+    if (!assembler.assembleResidual(solVector,fixedDoFs))
+        return false;
+
+    if (!tangentOp)
+        tangentOp.reset(new gsElasticityTangentOperator<T>(assembler));
+    tangentOp->setDisplacement(solVector,fixedDoFs);
+    const typename gsLinearOperator<T>::Ptr op = tangentOp;
+    typename gsLinearOperator<T>::Ptr precond;
+    if (m_options.getInt("Precond") != linear_precond::none)
+    {
+        gsMatrix<T> diagonal;
+        tangentOp->diagonal(diagonal);
+        precond.reset(new gsElJacobiOp<T>(diagonal));
+    }
+
+    const gsMatrix<T> rhs = assembler.rhs().col(0);
+    gsMatrix<T> x;
+    x.setZero(assembler.numDofs(),1);
+    if (m_options.getInt("Solver") == linear_solver::CG)
+    {
+        gsConjugateGradient<T> krylovSolver(op,precond);
+        solveKrylov(krylovSolver,rhs,x);
+    }
+    else if (m_options.getInt("Solver") == linear_solver::MINRES)
+    {
+        gsMinimalResidual<T> krylovSolver(op,precond);
+        solveKrylov(krylovSolver,rhs,x);
+    }
+    else
+    {
+        gsGMRes<T> krylovSolver(op,precond);
+        solveKrylov(krylovSolver,rhs,x);
+    }
+    update = x;
+    return true;
+}
+
+template <class T>
+bool gsIterative<T>::updateJacobian() const
+{
+    // the first iteration always needs a Jacobian; Dirichlet DoFs are eliminated at this point.
+    // the "next" iteration type has no residual form, so the full system is needed every time
+    if (numIterations == 0 || !linSolver.factorized() ||
+        m_options.getInt("IterType") == iteration_type::next)
+        return true;
+
+    switch (m_options.getInt("JacobianUpdate"))
+    {
+    case jacobian_update::every_k:
+        return numIterations - lastJacobianIter >= m_options.getInt("JacobianUpdateFreq");
+    case jacobian_update::stagnation:
+        return numIterations - lastJacobianIter > 1 &&
+               residualNorm > m_options.getReal("StagnationRatio")*oldResidualNorm;
+    default:
+        return true;
+    }
+}
+
+template <class T>
+T gsIterative<T>::lineSearch(const gsVector<T> & update)
+{
+    // without a residual-only assembly, the trial evaluations overwrite the matrix
+    // which is still needed by the modified Newton's method and the Krylov solvers
+    const bool keepMatrix = !assembler.hasResidualAssembly();
+    if (keepMatrix)
+        savedMatrix = assembler.matrix();
+    // residual at the current solution; assembler.rhs() is -r. With a pending Dirichlet increment,
+    // the rhs of the Newton's system contains the increment, so the residual is evaluated without it
+    T step = 0.;
+    if (!dirichletPending)
+        step = lineSearchStep(update,residualNorm,update.dot(assembler.rhs().col(0)));
+    else if (trialResidual(update,0.))
+        step = lineSearchStep(update,assembler.rhs().norm(),update.dot(assembler.rhs().col(0)));
+    if (keepMatrix)
+    {
+        assembler.setMatrix(savedMatrix);
+        savedMatrix.resize(0,0);
+    }
+    return step;
+}
+
+template <class T>
+T gsIterative<T>::lineSearchStep(const gsVector<T> & update, T resNorm0, T dirDeriv0)
+{
+    const index_t maxIters = m_options.getInt("LineSearchMaxIters");
+    const T shrink = m_options.getReal("LineSearchShrink");
+    const T minStep = m_options.getReal("LineSearchMinStep");
+
+    T step = 1.;
+    T validStep = 0.; // last step leading to a valid configuration
+    for (index_t i = 0; i <= maxIters && step >= minStep; ++i)
+    {
+        if (!trialResidual(update,step))
+        {   // invalid configuration: shrink the step instead of aborting
+            step *= shrink;
+            continue;
+        }
+        validStep = step;
+        if (m_options.getInt("LineSearch") == line_search::backtracking)
+        {
+            // Armijo condition on the residual norm
+            if (assembler.rhs().norm() <= (1 - m_options.getReal("LineSearchArmijo")*step)*resNorm0)
+                return step;
+            step *= shrink;
+        }
+        else // secant line search
+        {
+            const T dirDeriv = update.dot(assembler.rhs().col(0));
+            if (math::abs(dirDeriv) <= m_options.getReal("LineSearchTol")*math::abs(dirDeriv0))
+                return step;
+            // secant step for the root of du*r(u+s*du), safeguarded to stay in [shrink*step,1]
+            T newStep = dirDeriv0 != dirDeriv ? step*dirDeriv0/(dirDeriv0-dirDeriv) : step*shrink;
+            step = math::max(math::min(newStep,(T)1.),shrink*step);
+            if (step == validStep) // no progress possible
+                return step;
+        }
+    }
+    // no sufficient decrease; take the last valid step if there is one
+    return validStep;
+}
+
+template <class T>
+bool gsIterative<T>::trialResidual(const gsVector<T> & update, T step)
+{
+    trialSolVector = solVector + step*update;
+    trialFixedDoFs = fixedDoFs;
+    if (!dirichletPending)
+        return assembler.assembleResidual(trialSolVector,trialFixedDoFs);
+
+    // the pending Dirichlet increment is scaled together with the update; the full assembly would
+    // eliminate the increment held by the assembler once more, so it is set to zero for the evaluation
+    trialDdofs = assembler.allFixedDofs();
+    for (index_t d = 0; d < (index_t)(trialFixedDoFs.size()); ++d)
+        trialFixedDoFs[d] += step*trialDdofs[d];
+    assembler.homogenizeFixedDofs(-1);
+    const bool valid = assembler.assembleResidual(trialSolVector,trialFixedDoFs);
+    assembler.setFixedDofs(trialDdofs);
+    return valid;
+}
+
+template <class T>
+void gsIterative<T>::updateSchurOperators()
+{
+    gsSparseMatrix<T> mass, laplacian, convDiff;
+    // LSC is purely algebraic; the pressure mass matrix is still used to determine the size of the pressure block
+    std::vector<gsMatrix<T> > ddofs(fixedDoFs);
+    // with the update iteration type, the pending Dirichlet increment is added;
+    // with the next type, fixedDoFs already hold the full values
+    if (dirichletPending && m_options.getInt("IterType") == iteration_type::update)
+        for (index_t d = 0; d < (index_t)(ddofs.size()); ++d)
+            ddofs[d] += assembler.fixedDofs(d);
+    const T coef = assembler.assembleSchurOperators(solVector,ddofs,mass,laplacian,convDiff);
+    GISMO_ENSURE(coef > 0.,"The block-triangular preconditioner requires a mixed formulation!");
+    linSolver.setSaddlePoint(m_options.getInt("SchurApprox"),m_options.getInt("VelocityPrecond"),
+                             mass,laplacian,convDiff,coef);
+}
+
 template <class T>
 std::string gsIterative<T>::status()
 {
@@ -203,7 +442,12 @@ std::string gsIterative<T>::status()
                  ", updAbs: " + util::to_string(updateNorm) +
                  ", updRel: " + util::to_string(updateNorm/initUpdateNorm) +
                  ", resAbs: " + util::to_string(residualNorm) +
-                 ", resRel: " + util::to_string(residualNorm/initResidualNorm);
+                 ", resRel: " + util::to_string(residualNorm/initResidualNorm) +
+                 (m_options.getInt("LineSearch") != line_search::none ? ", step: " + util::to_string(stepLength) : "") +
+                 (m_options.getSwitch("MatrixFree") ? ", linIts: " + util::to_string(mfIterations) :
+                  linSolver.krylov() ? ", linIts: " + util::to_string(linSolver.iterations()) : "");
+    if (linSolver.krylov() && m_status != solver_status::working)
+        statusString += "\nKrylov solver: " + linSolver.status();
     return statusString;
 }
 
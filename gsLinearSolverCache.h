@@ -0,0 +1,173 @@
+/** @file gsLinearSolverCache.h
+
+    @brief A persistent sparse linear solver which reuses the symbolic analysis
+    for matrices with an unchanged sparsity pattern.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsSolver/gsLinearOperator.h>
+#include <gsElasticity/gsBaseUtils.h>
+#include <gsElasticity/gsSparseCombination.h>
+
+namespace gismo
+{
+
+/** @brief Keeps a sparse solver alive between several linear solves.
+ *
+ * Nonlinear and time-dependent solvers produce sequences of matrices with the same sparsity pattern.
+ * The fill-reducing ordering and the symbolic analysis then only have to be done once. The pattern is
+ * identified by the matrix size, the number of nonzeros and a hash of the compressed storage indices;
+ * the analysis is repeated automatically if any of those change. The matrix must be compressed.
+ *
+ * For the Krylov solvers (linear_solver::CG, MINRES, GMRES), the preconditioner takes the place of the factorization.
+ * It is kept for subsequent matrices with the same pattern as long as the number of Krylov iterations
+ * does not grow beyond *refresh* times the number of iterations right after its setup.
+ * The Krylov solvers do not copy the matrix: the matrix passed to factorize() must stay alive and unchanged
+ * until the last solve with it. MINRES needs a symmetric positive definite preconditioner, so the default
+ * linear_precond::ILUT is replaced by Jacobi scaling in this case.
+*/
+template <class T>
+class gsLinearSolverCache
+{
+public:
+    /// constructor with a linear solver type, see linear_solver
+    gsLinearSolverCache(index_t solverType = linear_solver::LU);
+
+    /// set the linear solver type; resets the cache if the type changes
+    void setSolver(index_t solverType);
+
+    /// returns the current linear solver type
+    index_t solver() const { return m_solver; }
+
+    /// numerical factorization of a given matrix; symbolic analysis is only done for a new pattern.
+    /// The Krylov solvers keep a pointer to the matrix instead of a factorization
+    void factorize(const gsSparseMatrix<T> & matrix);
+
+    /// solve a system with the last factorized matrix; rhs may have several columns
+    gsMatrix<T> solve(const gsMatrix<T> & rhs);
+
+    /// returns true if a factorization is available
+    bool factorized() const { return m_factorized; }
+
+    /// forget the stored pattern and the factorization
+    void reset();
+
+    /// number of symbolic analyses performed since the last reset
+    index_t numAnalyses() const { return m_numAnalyses; }
+
+    /// number of numerical factorizations performed since the last reset
+    index_t numFactorizations() const { return m_numFactorizations; }
+
+    //--------------------- KRYLOV SOLVERS ----------------------------------//
+
+    /// returns true if the solver type is one of the preconditioned Krylov solvers
+    bool krylov() const;
+
+    /// set the preconditioner type for the Krylov solvers, see linear_precond
+    void setPreconditioner(index_t precondType);
+
+    /// set the relative residual tolerance and the maximum number of iterations of the Krylov solvers
+    void setTolerance(T tol) { m_tolerance = tol; }
+    void setMaxIterations(index_t maxIters) { m_maxIters = maxIters; }
+
+    /// keep the preconditioner while the iteration count stays below refresh * (iterations after setup);
+    /// refresh <= 0 rebuilds the preconditioner for every matrix
+    void setPrecondRefresh(T refresh) { m_refresh = refresh; }
+
+    /// sizes of the diagonal blocks for linear_precond::block_jacobi and block_triangular
+    void setBlockSizes(const std::vector<index_t> & blockSizes) { m_blockSizes = blockSizes; }
+
+    /// set up linear_precond::block_triangular for saddle-point systems with the pressure as the last block:
+    /// the Schur complement approximation (see schur_approx), the preconditioner type of the velocity block and
+    /// the pressure operators as provided by gsBaseAssembler::assembleSchurOperators; only used at the next setup
+    void setSaddlePoint(index_t schurApprox, index_t velocityPrecond,
+                        const gsSparseMatrix<T> & mass, const gsSparseMatrix<T> & laplacian,
+                        const gsSparseMatrix<T> & convDiff, T coef);
+
+    /// number of Krylov iterations of the last solve (maximum over the columns of the rhs)
+    index_t iterations() const { return m_iterations; }
+    /// total number of Krylov iterations since the last reset
+    index_t totalIterations() const { return m_totalIterations; }
+    /// relative residual reached by the last solve
+    T error() const { return m_error; }
+    /// number of preconditioner setups since the last reset
+    index_t numPrecondSetups() const { return m_numSetups; }
+    /// accumulated wall time of the preconditioner setups and of the Krylov solves, in seconds
+    double setupTime() const { return m_setupTime; }
+    double solveTime() const { return m_solveTime; }
+
+    /// a one-line summary of the Krylov solver statistics
+    std::string status() const;
+
+protected:
+    template <class Solver>
+    void factorizeWith(Solver & solver, const gsSparseMatrix<T> & matrix, bool analyze)
+    {
+        if (analyze)
+            solver.analyzePattern(matrix);
+        solver.factorize(matrix);
+    }
+
+    /// constructs the preconditioner for the current matrix
+    void setupPreconditioner();
+
+    template <class Solver>
+    void solveWith(Solver & solver, const gsMatrix<T> & rhs, gsMatrix<T> & x)
+    {
+        solver.setTolerance(m_tolerance);
+        solver.setMaxIterations(m_maxIters);
+        solver.solve(rhs,x);
+        m_iterations = std::max(m_iterations,(index_t)solver.iterations());
+        m_error = std::max(m_error,(T)solver.error());
+    }
+
+protected:
+    /// linear solver type
+    index_t m_solver;
+    /// stored pattern info
+    index_t m_rows, m_cols, m_nonZeros;
+    size_t m_hash;
+    /// status variables
+    bool m_factorized;
+    index_t m_numAnalyses, m_numFactorizations;
+    /// solvers; only one of them is in use at a time
+#ifdef GISMO_WITH_PARDISO
+    typename gsSparseSolver<T>::PardisoLU solverLU;
+    typename gsSparseSolver<T>::PardisoLDLT solverLDLT;
+#else
+    typename gsSparseSolver<T>::LU solverLU;
+    typename gsSparseSolver<T>::SimplicialLDLT solverLDLT;
+#endif
+    typename gsSparseSolver<T>::CGDiagonal solverCG;
+    typename gsSparseSolver<T>::BiCGSTABDiagonal solverBiCGSTAB;
+    /// Krylov solvers: the last factorized matrix (not owned) and the preconditioner
+    const gsSparseMatrix<T> * m_matrix;
+    typename gsLinearOperator<T>::Ptr m_precond;
+    index_t m_precondType, m_maxIters;
+    T m_tolerance, m_refresh;
+    std::vector<index_t> m_blockSizes;
+    /// saddle-point preconditioner data
+    index_t m_schurApprox, m_velocityPrecond;
+    gsSparseMatrix<T> m_presMass, m_presLaplacian, m_presConvDiff;
+    T m_schurCoef;
+    index_t m_iterations, m_totalIterations, m_setupIterations, m_numSetups;
+    T m_error;
+    double m_setupTime, m_solveTime;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsLinearSolverCache.hpp)
+#endif
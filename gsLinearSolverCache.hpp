@@ -0,0 +1,238 @@
+/** @file gsLinearSolverCache.hpp
+
+    @brief Implementation of gsLinearSolverCache.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsLinearSolverCache.h>
+#include <gsElasticity/gsElPreconditioners.h>
+
+#include <gsSolver/gsConjugateGradient.h>
+#include <gsSolver/gsMinimalResidual.h>
+#include <gsSolver/gsGMRes.h>
+#include <gsUtils/gsStopwatch.h>
+
+namespace gismo
+{
+
+template <class T>
+gsLinearSolverCache<T>::gsLinearSolverCache(index_t solverType)
+    : m_solver(solverType),
+      m_precondType(linear_precond::ILUT),
+      m_maxIters(1000),
+      m_tolerance(1e-8),
+      m_refresh(2.),
+      m_schurApprox(schur_approx::mass),
+      m_velocityPrecond(linear_precond::ILUT),
+      m_schurCoef(1.)
+{
+    reset();
+}
+
+template <class T>
+void gsLinearSolverCache<T>::setSolver(index_t solverType)
+{
+    if (solverType != m_solver)
+    {
+        m_solver = solverType;
+        reset();
+    }
+}
+
+template <class T>
+void gsLinearSolverCache<T>::reset()
+{
+    m_rows = m_cols = m_nonZeros = -1;
+    m_hash = 0;
+    m_factorized = false;
+    m_numAnalyses = 0;
+    m_numFactorizations = 0;
+    m_matrix = nullptr;
+    m_precond.reset();
+    m_iterations = m_totalIterations = m_setupIterations = m_numSetups = 0;
+    m_error = 0.;
+    m_setupTime = m_solveTime = 0.;
+}
+
+template <class T>
+bool gsLinearSolverCache<T>::krylov() const
+{
+    return m_solver == linear_solver::CG || m_solver == linear_solver::MINRES || m_solver == linear_solver::GMRES;
+}
+
+template <class T>
+void gsLinearSolverCache<T>::setPreconditioner(index_t precondType)
+{
+    if (precondType != m_precondType)
+    {
+        m_precondType = precondType;
+        m_precond.reset();
+    }
+}
+
+template <class T>
+void gsLinearSolverCache<T>::factorize(const gsSparseMatrix<T> & matrix)
+{
+    GISMO_ENSURE(matrix.isCompressed(),"The matrix must be compressed!");
+
+    // the hash is needed either to compare it with the stored one or to store it for a new pattern,
+    // so it is computed on every call; it is linear in the number of nonzeros, unlike the factorization
+    const size_t hash = sparsePatternHash(matrix);
+    const bool analyze = !m_factorized || matrix.rows() != m_rows || matrix.cols() != m_cols ||
+                         matrix.nonZeros() != m_nonZeros || hash != m_hash;
+
+    if (m_solver == linear_solver::LU)
+        factorizeWith(solverLU,matrix,analyze);
+    else if (m_solver == linear_solver::LDLT)
+        factorizeWith(solverLDLT,matrix,analyze);
+    else if (m_solver == linear_solver::CGDiagonal)
+        factorizeWith(solverCG,matrix,analyze);
+    else if (m_solver == linear_solver::BiCGSTABDiagonal)
+        factorizeWith(solverBiCGSTAB,matrix,analyze);
+    else if (krylov())
+    {
+        m_matrix = &matrix;
+        // the preconditioner of the previous matrix is kept while it remains effective
+        if (analyze || !m_precond || m_refresh <= 0 || (m_setupIterations > 0 && m_iterations > m_refresh*m_setupIterations))
+            setupPreconditioner();
+    }
+    else
+        GISMO_ERROR("Linear solver not supported: " + util::to_string(m_solver));
+
+    if (analyze)
+    {
+        m_rows = matrix.rows();
+        m_cols = matrix.cols();
+        m_nonZeros = matrix.nonZeros();
+        m_hash = hash;
+        ++m_numAnalyses;
+    }
+    ++m_numFactorizations;
+    m_factorized = true;
+}
+
+template <class T>
+gsMatrix<T> gsLinearSolverCache<T>::solve(const gsMatrix<T> & rhs)
+{
+    GISMO_ENSURE(m_factorized,"No factorization available!");
+    if (m_solver == linear_solver::LU)
+        return solverLU.solve(rhs);
+    if (m_solver == linear_solver::LDLT)
+        return solverLDLT.solve(rhs);
+    if (m_solver == linear_solver::CGDiagonal)
+        return solverCG.solve(rhs);
+    if (m_solver == linear_solver::BiCGSTABDiagonal)
+        return solverBiCGSTAB.solve(rhs);
+
+    gsStopwatch clock;
+    clock.restart();
+    gsMatrix<T> result(rhs.rows(),rhs.cols());
+    gsMatrix<T> b, x;
+    m_iterations = 0;
+    m_error = 0.;
+    for (index_t c = 0; c < rhs.cols(); ++c)
+    {
+        b = rhs.col(c);
+        x.setZero(rhs.rows(),1);
+        if (m_solver == linear_solver::CG)
+        {
+            gsConjugateGradient<T> krylovSolver(*m_matrix,m_precond);
+            solveWith(krylovSolver,b,x);
+        }
+        else if (m_solver == linear_solver::MINRES)
+        {
+            gsMinimalResidual<T> krylovSolver(*m_matrix,m_precond);
+            solveWith(krylovSolver,b,x);
+        }
+        else
+        {
+            gsGMRes<T> krylovSolver(*m_matrix,m_precond);
+            solveWith(krylovSolver,b,x);
+        }
+        result.col(c) = x;
+    }
+    // reference iteration count for the reuse criterion
+    if (m_setupIterations == 0)
+        m_setupIterations = std::max<index_t>(m_iterations,1);
+    m_totalIterations += m_iterations;
+    m_solveTime += clock.stop();
+    return result;
+}
+
+template <class T>
+void gsLinearSolverCache<T>::setupPreconditioner()
+{
+    gsStopwatch clock;
+    clock.restart();
+    const gsSparseMatrix<T> & matrix = *m_matrix;
+    // MINRES needs an SPD preconditioner; the incomplete LU factorization is not even symmetric
+    index_t precondType = m_precondType;
+    if (m_solver == linear_solver::MINRES)
+    {
+        GISMO_ENSURE(precondType != linear_precond::block_triangular,
+                     "The block-triangular preconditioner is not symmetric; use it with GMRES.");
+        if (precondType == linear_precond::ILUT)
+            precondType = linear_precond::jacobi;
+    }
+    if (precondType == linear_precond::block_triangular)
+    {
+        const index_t numPres = m_presMass.rows();
+        GISMO_ENSURE(numPres > 0,"Pressure operators are not set, see setSaddlePoint().");
+        const index_t numVel = matrix.rows() - numPres;
+        // the velocity block and its block structure (all blocks but the last one)
+        const gsSparseMatrix<T> velocityBlock = matrix.block(0,0,numVel,numVel);
+        std::vector<index_t> velocityBlocks(m_blockSizes);
+        if (!velocityBlocks.empty())
+            velocityBlocks.pop_back();
+        typename gsElBlockTriangularOp<T>::Ptr op(new gsElBlockTriangularOp<T>(matrix,numPres,
+                                                  makeElPreconditioner(m_velocityPrecond,velocityBlock,velocityBlocks)));
+        if (m_schurApprox == schur_approx::mass)
+            op->setMassSchur(m_presMass,m_schurCoef);
+        else if (m_schurApprox == schur_approx::PCD)
+            op->setPCDSchur(m_presMass,m_presLaplacian,m_presConvDiff);
+        else
+            op->setLSCSchur(matrix);
+        m_precond = op;
+    }
+    else
+        m_precond = makeElPreconditioner(precondType,matrix,m_blockSizes);
+    m_setupIterations = 0;
+    ++m_numSetups;
+    m_setupTime += clock.stop();
+}
+
+template <class T>
+void gsLinearSolverCache<T>::setSaddlePoint(index_t schurApprox, index_t velocityPrecond,
+                                           const gsSparseMatrix<T> & mass, const gsSparseMatrix<T> & laplacian,
+                                           const gsSparseMatrix<T> & convDiff, T coef)
+{
+    m_schurApprox = schurApprox;
+    m_velocityPrecond = velocityPrecond;
+    m_presMass = mass;
+    m_presLaplacian = laplacian;
+    m_presConvDiff = convDiff;
+    m_schurCoef = coef;
+}
+
+template <class T>
+std::string gsLinearSolverCache<T>::status() const
+{
+    return "linIts: " + util::to_string(m_iterations) +
+           ", linRes: " + util::to_string(m_error) +
+           ", totalLinIts: " + util::to_string(m_totalIterations) +
+           ", precSetups: " + util::to_string(m_numSetups) +
+           ", setup: " + secToHMS(m_setupTime) +
+           ", solve: " + secToHMS(m_solveTime);
+}
+
+} // namespace ends
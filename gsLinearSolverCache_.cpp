@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsLinearSolverCache.h>
+#include <gsElasticity/gsLinearSolverCache.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsLinearSolverCache<real_t>;
+}
@@ -0,0 +1,100 @@
+/** @file gsLoadStepping.h
+
+    @brief A load continuation driver with adaptive increments for nonlinear problems.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsIterative.h>
+
+namespace gismo
+{
+
+/** @brief Applies the loads of a nonlinear problem in several increments.
+ * The load parameter goes from 0 to 1 and scales both the body and surface forces (the assembler
+ * option "ForceScaling") and the Dirichlet values provided by the assembler at construction.
+ * Every increment is solved with gsIterative. The increment size is adapted to the number
+ * of Newton's iterations: it grows if the solver converged fast and shrinks if it converged slowly.
+ * Failed increments (invalid configuration or too many iterations) are rejected, the solver state is recovered
+ * and the increment is cut. The initial guess for every increment is extrapolated from the previous two solutions.
+*/
+template <class T>
+class gsLoadStepping
+{
+public:
+    /// constructor with a zero initial guess
+    gsLoadStepping(gsBaseAssembler<T> & assembler_);
+
+    /// default option list. used for initialization
+    static gsOptionList defaultOptions();
+
+    /// get options list to read or set parameters
+    gsOptionList & options() { return m_options; }
+
+    /// access to Newton's solver to set its options
+    gsIterative<T> & iterativeSolver() { return solver; }
+
+    /// apply the full load
+    void solve();
+
+    /// make a single load increment; returns true if the increment was accepted
+    bool makeStep();
+
+    /// returns the solution vector
+    const gsMatrix<T> & solution() const { return solver.solution(); }
+
+    /// returns the fixed degrees of freedom
+    const std::vector<gsMatrix<T> > & allFixedDofs() const { return solver.allFixedDofs(); }
+
+    /// current value of the load parameter from 0 to 1
+    T loadParameter() const { return load; }
+
+    /// return solver status
+    solver_status status() const { return m_status; }
+
+    /// number of accepted increments
+    index_t numberSteps() const { return numSteps; }
+
+    /// number of rejected increments
+    index_t numberRejected() const { return numRejected; }
+
+    /// total number of Newton's iterations, including rejected increments
+    index_t numberIterations() const { return numIterations; }
+
+protected:
+    /// assembler object that generates the linear system
+    gsBaseAssembler<T> & assembler;
+    /// Newton's solver for a single increment
+    gsIterative<T> solver;
+    /// option list
+    gsOptionList m_options;
+    /// Dirichlet DoFs corresponding to the full load
+    std::vector<gsMatrix<T> > fullDDoFs;
+    /// Dirichlet DoFs of the current increment
+    std::vector<gsMatrix<T> > incDDoFs;
+    /// solution before the last accepted increment; used for extrapolation
+    gsMatrix<T> oldSolVector;
+    /// ---- status variables ----- ///
+    solver_status m_status;
+    T load; /// current load parameter
+    T loadIncrement; /// next load increment
+    T oldLoadIncrement; /// last accepted load increment
+    index_t numSteps;
+    index_t numRejected;
+    index_t numIterations;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsLoadStepping.hpp)
+#endif
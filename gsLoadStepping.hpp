@@ -0,0 +1,123 @@
+/** @file gsLoadStepping.hpp
+
+    @brief A load continuation driver with adaptive increments for nonlinear problems.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsLoadStepping.h>
+
+#include <gsElasticity/gsBaseAssembler.h>
+
+namespace gismo
+{
+
+template <class T>
+gsLoadStepping<T>::gsLoadStepping(gsBaseAssembler<T> & assembler_)
+    : assembler(assembler_),
+      solver(assembler_), // zero initial guess, zero Dirichlet DoFs
+      m_options(defaultOptions())
+{
+    fullDDoFs = assembler.allFixedDofs();
+    incDDoFs = fullDDoFs;
+    m_status = solver_status::working;
+    load = 0.;
+    loadIncrement = m_options.getReal("InitStep");
+    oldLoadIncrement = 0.;
+    numSteps = 0;
+    numRejected = 0;
+    numIterations = 0;
+}
+
+template <class T>
+gsOptionList gsLoadStepping<T>::defaultOptions()
+{
+    gsOptionList opt;
+    opt.addReal("InitStep","Initial load increment",0.1);
+    opt.addReal("MinStep","Minimal load increment; the solver stops if the increment gets smaller",1e-4);
+    opt.addReal("MaxStep","Maximal load increment",1.);
+    opt.addInt("TargetIters","Desired number of Newton's iterations per increment",5);
+    opt.addReal("GrowthFactor","Maximal growth of the increment after a successful step",2.);
+    opt.addReal("CutFactor","Reduction of the increment after a failed step",0.5);
+    opt.addSwitch("Extrapolate","Extrapolate the initial guess from the previous increments",true);
+    opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all",solver_verbosity::none);
+    return opt;
+}
+
+template <class T>
+void gsLoadStepping<T>::solve()
+{
+    if (load == 0.)
+        loadIncrement = m_options.getReal("InitStep");
+    while (m_status == solver_status::working)
+        makeStep();
+
+    if (m_options.getInt("Verbosity") != solver_verbosity::none)
+        gsInfo << "Load stepping " << (m_status == solver_status::converged ? "finished" : "failed")
+               << " at load " << load << " after " << numSteps << " increment(s), "
+               << numRejected << " rejected, " << numIterations << " Newton's iteration(s) in total.\n";
+}
+
+template <class T>
+bool gsLoadStepping<T>::makeStep()
+{
+    const bool lastStep = loadIncrement >= 1-load;
+    const T step = lastStep ? 1-load : loadIncrement;
+    solver.saveState();
+    const gsMatrix<T> solVector = solver.solution();
+
+    // predictor: linear extrapolation from the last increment
+    if (m_options.getSwitch("Extrapolate") && oldLoadIncrement > 0.)
+        solver.setSolutionVector(solVector + step/oldLoadIncrement*(solVector-oldSolVector));
+    // loads at the end of the increment; the update iteration expects an increment of the Dirichlet values,
+    // the next iteration expects their absolute values
+    assembler.options().setReal("ForceScaling",load+step);
+    const T ddofScaling = solver.options().getInt("IterType") == iteration_type::update ? step : load+step;
+    for (size_t d = 0; d < fullDDoFs.size(); ++d)
+        incDDoFs[d] = ddofScaling*fullDDoFs[d];
+    assembler.setFixedDofs(incDDoFs);
+
+    solver.reset();
+    solver.solve();
+    const index_t iters = solver.numberIterations();
+    numIterations += iters;
+
+    if (solver.solverStatus() == solver_status::converged)
+    {
+        oldSolVector = solVector;
+        oldLoadIncrement = step;
+        load = lastStep ? 1. : load + step;
+        ++numSteps;
+        // increment adaptation: Delta_new = Delta*sqrt(target/iters), see Crisfield, Vol.1, p.287
+        T factor = math::sqrt(T(m_options.getInt("TargetIters"))/math::max(iters,(index_t)1));
+        factor = math::min(factor,m_options.getReal("GrowthFactor"));
+        loadIncrement = math::min(step*factor,m_options.getReal("MaxStep"));
+        if (m_options.getInt("Verbosity") == solver_verbosity::all)
+            gsInfo << "Increment " << numSteps << " accepted: load " << load << ", "
+                   << iters << " iteration(s), next increment " << loadIncrement << std::endl;
+        if (lastStep)
+            m_status = solver_status::converged;
+        return true;
+    }
+
+    // increment failed: go back to the last converged state and cut the increment
+    solver.recoverState();
+    ++numRejected;
+    loadIncrement = step*m_options.getReal("CutFactor");
+    if (m_options.getInt("Verbosity") == solver_verbosity::all)
+        gsInfo << "Increment rejected: " << solver.status() << " Retrying with " << loadIncrement << std::endl;
+    if (loadIncrement < m_options.getReal("MinStep"))
+        m_status = solver.solverStatus();
+    return false;
+}
+
+} // namespace ends
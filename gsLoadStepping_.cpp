@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsLoadStepping.h>
+#include <gsElasticity/gsLoadStepping.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsLoadStepping<real_t>;
+}
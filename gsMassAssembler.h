@@ -49,6 +49,13 @@ public:
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDDoFs) {assemble();}
 
+    /// @brief Assembles a diagonal approximation of the mass matrix for the free DoFs. The element contributions
+    /// are lumped before the elimination of Dirichlet DoFs, so the mass coupling free and fixed DoFs is kept.
+    /// Default is the row-sum lumping, i.e. the integrals of density*N_i, which is positive for B-splines and NURBS;
+    /// set *hrz* to true for the HRZ lumping (element-wise diagonal of the consistent mass matrix scaled to the element mass).
+    /// The assembled system stays untouched
+    void lumpedMassVector(gsMatrix<T> & result, bool hrz = false);
+
 protected:
     /// Dimension of the problem
     /// parametric dim = physical dim = deformation dim
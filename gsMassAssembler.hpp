@@ -80,27 +80,33 @@ void gsMassAssembler<T>::assemble(bool saveEliminationMatrix)
 {
     // allocate space for the linear system
     m_system.matrix().setZero();
+    Base::eliminationMatrixValid = false;
     m_system.reserve(m_bases[0], m_options, 1);
     m_system.rhs().setZero(Base::numDofs(),1);
 
-    if (saveEliminationMatrix)
-    {
-        eliminationMatrix.resize(Base::numDofs(),Base::numFixedDofs());
-        eliminationMatrix.setZero();
-        eliminationMatrix.reservePerColumn(m_system.numColNz(m_bases[0],m_options));
-    }
-
-    gsVisitorMass<T> visitor(saveEliminationMatrix ? &eliminationMatrix : nullptr);
+    gsSparseEntries<T> elimEntries;
+    gsVisitorMass<T> visitor(saveEliminationMatrix ? &elimEntries : nullptr);
     Base::template push<gsVisitorMass<T> >(visitor);
 
     m_system.matrix().makeCompressed();
 
     if (saveEliminationMatrix)
-    {
-        Base::rhsWithZeroDDofs = m_system.rhs();
-        eliminationMatrix.makeCompressed();
-    }
+        Base::setEliminationMatrix(elimEntries);
 }
 
+template<class T>
+void gsMassAssembler<T>::lumpedMassVector(gsMatrix<T> & result, bool hrz)
+{
+    // the lumped vector is assembled into the rhs which is restored afterwards
+    gsMatrix<T> rhsSaved;
+    rhsSaved.swap(m_system.rhs());
+    m_system.rhs().setZero(Base::numDofs(),1);
+
+    gsVisitorMass<T> visitor(hrz);
+    Base::template push<gsVisitorMass<T> >(visitor);
+
+    result.swap(m_system.rhs());
+    m_system.rhs().swap(rhsSaved);
+}
 
 }// namespace gismo ends
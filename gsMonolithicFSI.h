@@ -0,0 +1,200 @@
+/** @file gsMonolithicFSI.h
+
+    @brief Monolithic FSI solver.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsIO/gsOptionList.h>
+#include <gsElasticity/gsLinearSolverCache.h>
+#include <gsSolver/gsLinearOperator.h>
+#include <map>
+
+namespace gismo
+{
+
+template <class T>
+class gsNsTimeIntegrator;
+template <class T>
+class gsElTimeIntegrator;
+template <class T>
+class gsALE;
+template <class T>
+class gsMultiPatch;
+template <class T>
+class gsMonolithicFSIJacobianOp;
+template <class T>
+class gsMonolithicFSIPrecondOp;
+
+/** @brief Monolithic FSI solver: the flow and the structure are solved as one nonlinear system by Newton's method.
+ *
+ * The unknowns are the free DoFs of the flow and of the structure at the new time level. At each Newton's iteration,
+ * the flow mesh is moved by the ALE solver according to the current structure displacement, and the flow velocity
+ * at the FSI interface is set to the ALE velocity. The coupled Jacobian
+ *
+ *     | J_f   C_fs | |du_f|     |R_f|
+ *     | C_sf  J_s  | |du_s| = - |R_s|
+ *
+ * is solved by GMRES (gsGMRes) preconditioned with the block upper triangular matrix [J_f C_fs; 0 J_s] whose diagonal
+ * blocks are factorized by direct solvers. C_fs comes from the derivative of the flow residual w.r.t. the interface
+ * Dirichlet DoFs; C_sf (the dependence of the fluid load on the flow solution) is applied matrix-free via the solid
+ * residual since the load is linear in velocity and pressure.
+ *
+ * The Jacobian is inexact: the dependence of the flow equations on the mesh motion is not linearized. Neither the shape
+ * derivatives (the derivatives w.r.t. the position of the flow mesh) nor the derivative of the convective mesh velocity
+ * in the interior of the flow domain w.r.t. the structure displacement are included; only the interface velocity enters C_fs.
+ * The residual is always evaluated on the current mesh, so the converged solution is the solution of the coupled problem,
+ * but the method is an inexact Newton's method: it converges linearly rather than quadratically, and the rate
+ * deteriorates with large mesh deformations and large mesh velocities. Likewise, updates from GMRES iterations which
+ * did not reach LinearTol are used as they are; their number is reported by numberLinearFailures().
+ *
+ * The solver has the same interface as gsPartitionedFSI; both can be used with the same component solvers.
+ * Both the flow and the structure solver must use the implicit nonlinear time integration scheme.
+ */
+template <class T>
+class gsMonolithicFSI
+{
+    friend class gsMonolithicFSIJacobianOp<T>;
+    friend class gsMonolithicFSIPrecondOp<T>;
+
+public:
+
+    gsMonolithicFSI(gsNsTimeIntegrator<T> & nsSolver,
+                    gsMultiPatch<T> & velocity, gsMultiPatch<T> & pressure,
+                    gsElTimeIntegrator<T> & elSolver,
+                    gsMultiPatch<T> & displacement,
+                    gsALE<T> & aleSolver,
+                    gsMultiPatch<T> & aleDisplacement, gsMultiPatch<T> & aleVelocity);
+
+    /// default option list. used for initialization
+    static gsOptionList defaultOptions();
+
+    /// get options list to read or set parameters
+    gsOptionList & options() { return m_options; }
+
+    /// make the next time step
+    bool makeTimeStep(T timeStep);
+
+    /// number of Newton's iterations the solver took to converge at the last time step
+    index_t numberIterations() { return numIter; }
+    /// total number of GMRES iterations at the last time step
+    index_t numberLinearIterations() { return linIter; }
+    /// number of Newton's iterations at the last time step where GMRES did not reach LinearTol within LinearMaxIters
+    index_t numberLinearFailures() { return linFailures; }
+    /// amount of time consumed by each component at the last time step; the linear solver is counted separately
+    T timeNS() { return nsTime; }
+    T timeEL() { return elTime; }
+    T timeALE() { return aleTime; }
+    T timeLinear() { return linTime; }
+    /// residual norm of the coupled system
+    T residualNormAbs() { return absResNorm;}
+    /// relative residual norm of the coupled system
+    T residualNormRel() { return absResNorm/initResNorm; }
+
+protected:
+    /// finds the pairs (interface Dirichlet DoF of the flow, free interface DoF of the structure)
+    void initializeCoupling();
+
+    /// moves the flow mesh according to the current displacement and sets the interface velocity of the flow;
+    /// returns false if the ALE deformation is not bijective
+    bool moveMesh(T timeStep, bool recover);
+
+    /// forms the coupling block C_fs from the derivative of the flow residual w.r.t. its fixed DoFs
+    void formCoupling(T timeStep);
+
+    /// product of the coupled Jacobian with a vector
+    void applyJacobian(const gsMatrix<T> & vector, gsMatrix<T> & result);
+
+    /// application of the block upper triangular preconditioner
+    void applyPreconditioner(const gsMatrix<T> & vector, gsMatrix<T> & result);
+
+protected:
+    /// component solvers
+    gsNsTimeIntegrator<T> & m_nsSolver;
+    gsMultiPatch<T> & m_velocity;
+    gsMultiPatch<T> & m_pressure;
+    gsElTimeIntegrator<T> & m_elSolver;
+    gsMultiPatch<T> & m_displacement;
+    gsALE<T> & m_aleSolver;
+    gsMultiPatch<T> & m_ALEdisplacment;
+    gsMultiPatch<T> & m_ALEvelocity;
+    /// option list
+    gsOptionList m_options;
+    /// status variables
+    index_t numIter; // number of Newton's iterations at the last time step
+    index_t linIter; // number of GMRES iterations at the last time step
+    index_t linFailures; // number of unconverged GMRES solves at the last time step
+    bool converged; // convergence flag
+    T nsTime, elTime, aleTime, linTime; // component computational times
+    T absResNorm, initResNorm; // residual norms for convergence cretirion
+    /// coupled system
+    bool couplingInitialized;
+    std::map<index_t,index_t> couplingDofs; // fixed DoF of the flow -> free DoF of the structure
+    gsSparseMatrix<T> dirichletJac; // derivative of the flow residual w.r.t. the fixed DoFs of the flow
+    gsSparseMatrix<T> couplingFS; // C_fs
+    gsMatrix<T> fluidVector, solidVector; // current Newton's iterate
+    gsMatrix<T> solidRhs; // rhs of the structure at the current iterate, R_s = -solidRhs
+    gsLinearSolverCache<T> fluidSolver, solidSolver; // factorizations of the diagonal blocks
+    index_t numDofsFluid, numDofsSolid;
+};
+
+/// @brief Applies the coupled Jacobian of gsMonolithicFSI at the current Newton's iterate; used by GMRES
+template <class T>
+class gsMonolithicFSIJacobianOp : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsMonolithicFSIJacobianOp> Ptr;
+    typedef memory::unique_ptr<gsMonolithicFSIJacobianOp> uPtr;
+
+    gsMonolithicFSIJacobianOp(gsMonolithicFSI<T> & fsi) : m_fsi(fsi) {}
+
+    static uPtr make(gsMonolithicFSI<T> & fsi) { return uPtr(new gsMonolithicFSIJacobianOp(fsi)); }
+
+    /// x = J*input
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const { m_fsi.applyJacobian(input,x); }
+
+    virtual index_t rows() const { return m_fsi.numDofsFluid + m_fsi.numDofsSolid; }
+
+    virtual index_t cols() const { return rows(); }
+
+protected:
+    gsMonolithicFSI<T> & m_fsi;
+};
+
+/// @brief Applies the block upper triangular preconditioner of gsMonolithicFSI; the diagonal blocks must be factorized
+template <class T>
+class gsMonolithicFSIPrecondOp : public gsLinearOperator<T>
+{
+public:
+    typedef memory::shared_ptr<gsMonolithicFSIPrecondOp> Ptr;
+    typedef memory::unique_ptr<gsMonolithicFSIPrecondOp> uPtr;
+
+    gsMonolithicFSIPrecondOp(gsMonolithicFSI<T> & fsi) : m_fsi(fsi) {}
+
+    static uPtr make(gsMonolithicFSI<T> & fsi) { return uPtr(new gsMonolithicFSIPrecondOp(fsi)); }
+
+    /// x = P^-1*input
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const { m_fsi.applyPreconditioner(input,x); }
+
+    virtual index_t rows() const { return m_fsi.numDofsFluid + m_fsi.numDofsSolid; }
+
+    virtual index_t cols() const { return rows(); }
+
+protected:
+    gsMonolithicFSI<T> & m_fsi;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsMonolithicFSI.hpp)
+#endif
@@ -0,0 +1,316 @@
+/** @file gsMonolithicFSI.hpp
+
+    @brief Implementation of gsMonolithicFSI.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsMonolithicFSI.h>
+
+#include <gsElasticity/gsNsTimeIntegrator.h>
+#include <gsElasticity/gsElTimeIntegrator.h>
+#include <gsElasticity/gsALE.h>
+#include <gsUtils/gsStopwatch.h>
+#include <gsSolver/gsGMRes.h>
+
+namespace gismo
+{
+
+template <class T>
+gsMonolithicFSI<T>::gsMonolithicFSI(gsNsTimeIntegrator<T> & nsSolver,
+                                    gsMultiPatch<T> & velocity, gsMultiPatch<T> & pressure,
+                                    gsElTimeIntegrator<T> & elSolver,
+                                    gsMultiPatch<T> & displacement,
+                                    gsALE<T> & aleSolver,
+                                    gsMultiPatch<T> & aleDisplacement, gsMultiPatch<T> & aleVelocity) :
+    m_nsSolver(nsSolver),
+    m_velocity(velocity),
+    m_pressure(pressure),
+    m_elSolver(elSolver),
+    m_displacement(displacement),
+    m_aleSolver(aleSolver),
+    m_ALEdisplacment(aleDisplacement),
+    m_ALEvelocity(aleVelocity),
+    m_options(defaultOptions()),
+    numIter(0),
+    linIter(0),
+    linFailures(0),
+    couplingInitialized(false),
+    fluidSolver(linear_solver::LU),
+    solidSolver(linear_solver::LU)
+{
+
+}
+
+template <class T>
+gsOptionList gsMonolithicFSI<T>::defaultOptions()
+{
+    gsOptionList opt;
+    opt.addInt("MaxIter","Maximum number of Newton's iterations per time step",10);
+    opt.addReal("AbsTol","Absolute tolerance for the convergence creterion",1e-10);
+    opt.addReal("RelTol","Relative tolerance for the convergence creterion",1e-6);
+    opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all",solver_verbosity::none);
+    opt.addInt("LinearMaxIters","Maximum number of GMRES iterations per Newton's iteration",100);
+    opt.addReal("LinearTol","Relative residual tolerance of GMRES",1e-6);
+    return opt;
+}
+
+template <class T>
+bool gsMonolithicFSI<T>::makeTimeStep(T timeStep)
+{
+    GISMO_ENSURE(m_nsSolver.options().getInt("Scheme") == time_integration::implicit_nonlinear &&
+                 m_elSolver.options().getInt("Scheme") == time_integration::implicit_nonlinear,
+                 "The monolithic FSI solver requires implicit nonlinear time integration of the flow and the structure");
+    if (!couplingInitialized)
+        initializeCoupling();
+
+    // save states of the component solvers at the beginning of the time step
+    m_nsSolver.saveState();
+    m_elSolver.saveState();
+    m_aleSolver.saveState();
+
+    // reset the solver
+    numIter = 0;
+    linIter = 0;
+    linFailures = 0;
+    converged = false;
+    const index_t verbosity = m_options.getInt("Verbosity");
+
+    // reset time profiling info
+    gsStopwatch clock;
+    nsTime = elTime = aleTime = linTime = 0.;
+
+    // initial guess is the solution at the beginning of the time step
+    fluidVector = m_nsSolver.solutionVector();
+    solidVector = m_elSolver.solutionVector();
+    numDofsFluid = fluidVector.rows();
+    numDofsSolid = solidVector.rows();
+    m_elSolver.beginTimeStep(timeStep);
+    gsMatrix<T> residual(numDofsFluid+numDofsSolid,1);
+
+    while (true)
+    {
+        // ============= Flow mesh/ALE section ===================== //
+        clock.restart();
+        m_elSolver.assembler().constructSolution(solidVector,m_elSolver.allFixedDofs(),m_displacement);
+        if (!moveMesh(timeStep,numIter > 0))
+            return false; // if the new ALE deformation is not bijective, stop the simulation
+        aleTime += clock.stop();
+        // =================================================================== //
+
+
+        // ======================= Flow section ============================== //
+        clock.restart();
+        // the rhs of the time step depends on the new interface velocity and on the new mesh
+        m_nsSolver.recoverState();
+        m_nsSolver.beginTimeStep(timeStep);
+        m_nsSolver.assemble(fluidVector,m_nsSolver.assembler().allFixedDofs());
+        m_nsSolver.constructSolution(fluidVector,m_velocity,m_pressure);
+        residual.topRows(numDofsFluid) = m_nsSolver.matrix()*fluidVector - m_nsSolver.rhs();
+        nsTime += clock.stop();
+        // =================================================================== //
+
+
+        // ================== Structure section ============================== //
+        clock.restart();
+        if (!m_elSolver.assemble(solidVector,m_elSolver.allFixedDofs()))
+            return false; // invalid configuration of the structure
+        solidRhs = m_elSolver.rhs();
+        residual.bottomRows(numDofsSolid) = -solidRhs;
+        elTime += clock.stop();
+        // =================================================================== //
+
+        absResNorm = residual.norm()/sqrt(residual.rows());
+        if (numIter == 0)
+            initResNorm = absResNorm;
+        if (numIter > 0 && verbosity == solver_verbosity::all)
+            gsInfo << numIter << ": absRes " << absResNorm << ", relRes " << absResNorm/initResNorm << std::endl;
+        if (absResNorm < m_options.getReal("AbsTol") || absResNorm < m_options.getReal("RelTol")*initResNorm)
+        {
+            converged = true;
+            break;
+        }
+        if (numIter == m_options.getInt("MaxIter"))
+            break;
+
+        // ===================== Newton's update ============================= //
+        clock.restart();
+        formCoupling(timeStep);
+        fluidSolver.factorize(m_nsSolver.matrix());
+        solidSolver.factorize(m_elSolver.matrix());
+        const gsMatrix<T> newtonRhs = -residual;
+        gsMatrix<T> update;
+        update.setZero(numDofsFluid+numDofsSolid,1);
+        const typename gsLinearOperator<T>::Ptr jacobian = gsMonolithicFSIJacobianOp<T>::make(*this);
+        const typename gsLinearOperator<T>::Ptr precond = gsMonolithicFSIPrecondOp<T>::make(*this);
+        gsGMRes<T> krylovSolver(jacobian,precond);
+        krylovSolver.setTolerance(m_options.getReal("LinearTol"));
+        krylovSolver.setMaxIterations(m_options.getInt("LinearMaxIters"));
+        krylovSolver.solve(newtonRhs,update);
+        linIter += krylovSolver.iterations();
+        if (krylovSolver.error() > krylovSolver.tolerance())
+        {
+            ++linFailures;
+            if (m_options.getInt("Verbosity") == solver_verbosity::all)
+                gsInfo << "GMRES did not converge after " << krylovSolver.iterations() << " iterations, relRes "
+                       << krylovSolver.error() << std::endl;
+        }
+        fluidVector += update.topRows(numDofsFluid);
+        solidVector += update.bottomRows(numDofsSolid);
+        linTime += clock.stop();
+        // =================================================================== //
+
+        ++numIter;
+    }
+
+    // the flow fields, the displacement and the mesh correspond to the last iterate
+    m_nsSolver.finishTimeStep(fluidVector,numIter);
+    m_elSolver.finishTimeStep(solidVector,numIter);
+
+    if (verbosity != solver_verbosity::none && numIter > 0)
+    {
+        if (converged)
+            gsInfo << "Converged after " << numIter << " iters (" << linIter << " GMRES iters), absRes "
+                   << absResNorm << ", relRes " << absResNorm/initResNorm << std::endl;
+        else
+            gsInfo << "Terminated after " << numIter << " iters (" << linIter << " GMRES iters), absRes "
+                   << absResNorm << ", relRes " << absResNorm/initResNorm << std::endl;
+        if (linFailures > 0)
+            gsInfo << "GMRES did not converge in " << linFailures << " of " << numIter << " Newton's iterations\n";
+    }
+
+    return true;
+}
+
+template <class T>
+void gsMonolithicFSI<T>::initializeCoupling()
+{
+    // the coupling block needs the derivative of the flow residual w.r.t. the interface Dirichlet DoFs
+    m_nsSolver.assembler().options().setSwitch("EliminationMatrix",true);
+
+    const short_t dim = m_nsSolver.assembler().patches().targetDim();
+    couplingDofs.clear();
+    gsMatrix<index_t> fluidFree, fluidFixed, solidFree, solidFixed;
+    for (size_t p = 0; p < m_nsSolver.aleInterface().sidesA.size(); ++p)
+    {
+        const patchSide & sideALE = m_nsSolver.aleInterface().sidesA[p];
+        const patchSide & sideFlow = m_nsSolver.aleInterface().sidesB[p];
+        // find the structure side which drives this side of the ALE domain
+        size_t i = 0;
+        while (i < m_aleSolver.interface().sidesB.size() &&
+               !(m_aleSolver.interface().sidesB[i].patch == sideALE.patch &&
+                 m_aleSolver.interface().sidesB[i].index() == sideALE.index()))
+            ++i;
+        GISMO_ENSURE(i < m_aleSolver.interface().sidesB.size(),"Side " + util::to_string(sideALE.side()) + " of ALE patch "
+                     + util::to_string(sideALE.patch) + " does not belong to the FSI interface");
+        const patchSide & sideSolid = m_aleSolver.interface().sidesA[i];
+
+        m_nsSolver.assembler().sideDofIndices(sideFlow.patch,sideFlow.side(),dim,fluidFree,fluidFixed);
+        m_elSolver.assembler().sideDofIndices(sideSolid.patch,sideSolid.side(),dim,solidFree,solidFixed);
+        GISMO_ENSURE(fluidFixed.rows() == solidFree.rows(),"Bases of the flow and of the structure do not match at the FSI interface");
+        // corner DoFs shared by several sides are only added once
+        for (index_t j = 0; j < fluidFixed.rows(); ++j)
+            for (short_t d = 0; d < dim; ++d)
+                if (fluidFixed(j,d) >= 0 && solidFree(j,d) >= 0)
+                    couplingDofs[fluidFixed(j,d)] = solidFree(j,d);
+    }
+    couplingInitialized = true;
+}
+
+template <class T>
+bool gsMonolithicFSI<T>::moveMesh(T timeStep, bool recover)
+{
+    // recover ALE at the start of timestep
+    if (recover)
+        m_aleSolver.recoverState();
+
+    // undo last ALE deformation of the flow domain
+    for (index_t p = 0; p < m_nsSolver.aleInterface().patches.size(); ++p)
+    {
+        index_t pFlow = m_nsSolver.aleInterface().patches[p].second;
+        index_t pALE = m_nsSolver.aleInterface().patches[p].first;
+        m_nsSolver.assembler().patches().patch(pFlow).coefs() -= m_ALEdisplacment.patch(pALE).coefs();
+        m_nsSolver.mAssembler().patches().patch(pFlow).coefs() -= m_ALEdisplacment.patch(pALE).coefs();
+    }
+
+    // save ALE displacement at the beginning of the time step for ALE velocity computation
+    m_aleSolver.constructSolution(m_ALEvelocity);
+    // update ALE
+    if (m_aleSolver.updateMesh() != -1)
+        return false;
+    // construct new ALE displacement
+    m_aleSolver.constructSolution(m_ALEdisplacment);
+    for (index_t p = 0; p < m_ALEvelocity.nPatches(); ++p)
+        m_ALEvelocity.patch(p).coefs() = (m_ALEdisplacment.patch(p).coefs() - m_ALEvelocity.patch(p).coefs()) / timeStep;
+
+    // apply new ALE deformation to the flow domain
+    for (index_t p = 0; p < m_nsSolver.aleInterface().patches.size(); ++p)
+    {
+        index_t pFlow = m_nsSolver.aleInterface().patches[p].second;
+        index_t pALE = m_nsSolver.aleInterface().patches[p].first;
+        m_nsSolver.assembler().patches().patch(pFlow).coefs() += m_ALEdisplacment.patch(pALE).coefs();
+        m_nsSolver.mAssembler().patches().patch(pFlow).coefs() += m_ALEdisplacment.patch(pALE).coefs();
+    }
+
+    // set velocity boundary condition on the FSI interface; velocity comes from the ALE velocity
+    for (index_t p = 0; p < m_nsSolver.aleInterface().sidesA.size(); ++p)
+    {
+        index_t pFlow = m_nsSolver.aleInterface().sidesB[p].patch;
+        boxSide sFlow = m_nsSolver.aleInterface().sidesB[p].side();
+        index_t pALE = m_nsSolver.aleInterface().sidesA[p].patch;
+        boxSide sALE = m_nsSolver.aleInterface().sidesA[p].side();
+        m_nsSolver.assembler().setFixedDofs(pFlow,sFlow,m_ALEvelocity.patch(pALE).boundary(sALE)->coefs());
+    }
+
+    return true;
+}
+
+template <class T>
+void gsMonolithicFSI<T>::formCoupling(T timeStep)
+{
+    // the interface velocity of the flow is (u_s - u_s,n)/dt; the columns of the fixed interface DoFs of the flow
+    // are moved to the columns of the corresponding free DoFs of the structure
+    m_nsSolver.dirichletJacobian(dirichletJac);
+    gsSparseEntries<T> entries;
+    for (typename std::map<index_t,index_t>::const_iterator it = couplingDofs.begin(); it != couplingDofs.end(); ++it)
+        for (typename gsSparseMatrix<T>::InnerIterator jt(dirichletJac,it->first); jt; ++jt)
+            entries.add(jt.row(),it->second,jt.value()/timeStep);
+    couplingFS.resize(numDofsFluid,numDofsSolid);
+    couplingFS.setFrom(entries);
+    couplingFS.makeCompressed();
+}
+
+template <class T>
+void gsMonolithicFSI<T>::applyJacobian(const gsMatrix<T> & vector, gsMatrix<T> & result)
+{
+    const gsMatrix<T> vecFluid = vector.topRows(numDofsFluid);
+    const gsMatrix<T> vecSolid = vector.bottomRows(numDofsSolid);
+    result.resize(numDofsFluid+numDofsSolid,1);
+    result.topRows(numDofsFluid) = m_nsSolver.matrix()*vecFluid + couplingFS*vecSolid;
+    // C_sf*v = R_s(u_f + v) - R_s(u_f) is exact since the fluid load is linear in velocity and pressure;
+    // the flow fields are reset to the current iterate at the next Newton's iteration
+    m_nsSolver.constructSolution(fluidVector + vecFluid,m_velocity,m_pressure);
+    m_elSolver.assembleResidual(solidVector,m_elSolver.allFixedDofs());
+    result.bottomRows(numDofsSolid) = m_elSolver.matrix()*vecSolid + solidRhs - m_elSolver.rhs();
+}
+
+template <class T>
+void gsMonolithicFSI<T>::applyPreconditioner(const gsMatrix<T> & vector, gsMatrix<T> & result)
+{
+    result.resize(numDofsFluid+numDofsSolid,1);
+    const gsMatrix<T> vecSolid = vector.bottomRows(numDofsSolid);
+    result.bottomRows(numDofsSolid) = solidSolver.solve(vecSolid);
+    const gsMatrix<T> vecFluid = vector.topRows(numDofsFluid) - couplingFS*result.bottomRows(numDofsSolid);
+    result.topRows(numDofsFluid) = fluidSolver.solve(vecFluid);
+}
+
+} // namespace ends
@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsMonolithicFSI.h>
+#include <gsElasticity/gsMonolithicFSI.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsMonolithicFSI<real_t>;
+}
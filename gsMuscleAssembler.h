@@ -38,14 +38,6 @@ public:
                       const gsPiecewiseFunction<T> & tendonMuscleDistribution,
                       const gsVector<T> & fiberDirection);
 
-    //--------------------- SYSTEM ASSEMBLY ----------------------------------//
-
-    /// Assembles the tangential linear system for Newton's method given the current solution
-    /// in the form of free and fixed/Dirichelt degrees of freedom.
-    /// Checks if the current solution is valid (Newton's solver can exit safely if invalid).
-    virtual bool assemble(const gsMatrix<T> & solutionVector,
-                          const std::vector<gsMatrix<T> > & fixedDoFs);
-
     //--------------------- SPECIALS ----------------------------------//
 
     /// @brief Construct Cauchy stresses for evaluation or visualization
@@ -54,6 +46,16 @@ public:
                                          gsPiecewiseFunction<T> & result,
                                          stress_components::components component = stress_components::von_mises) const;
 
+protected:
+    //--------------------- SYSTEM ASSEMBLY ----------------------------------//
+
+    /// Assembles the tangential linear system (or only the residual if *assembleMatrix* is false)
+    /// for Newton's method given the current solution in the form of free and fixed/Dirichelt degrees of freedom.
+    /// Checks if the current solution is valid (Newton's solver can exit safely if invalid).
+    virtual bool assembleNonlinear(const gsMatrix<T> & solutionVector,
+                                   const std::vector<gsMatrix<T> > & fixedDoFs,
+                                   bool assembleMatrix);
+
 protected:
     using Base::m_options;
     using Base::m_pde_ptr;
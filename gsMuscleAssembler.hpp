@@ -55,8 +55,9 @@ gsMuscleAssembler<T>::gsMuscleAssembler(gsMultiPatch<T> const & patches,
 
 
 template<class T>
-bool gsMuscleAssembler<T>::assemble(const gsMatrix<T> & solutionVector,
-                                    const std::vector<gsMatrix<T> > & fixedDoFs)
+bool gsMuscleAssembler<T>::assembleNonlinear(const gsMatrix<T> & solutionVector,
+                                             const std::vector<gsMatrix<T> > & fixedDoFs,
+                                             bool assembleMatrix)
 {
     gsMultiPatch<T> displacement,pressure;
     Base::constructSolution(solutionVector,fixedDoFs,displacement,pressure);
@@ -64,18 +65,24 @@ bool gsMuscleAssembler<T>::assemble(const gsMatrix<T> & solutionVector,
         if (checkDisplacement(m_pde_ptr->patches(),displacement) != -1)
             return false;
 
-    m_system.matrix().setZero();
-    Base::reserve();
+    if (assembleMatrix)
+    {
+        m_system.matrix().setZero();
+        Base::eliminationMatrixValid = false;
+        Base::reserve();
+    }
     m_system.rhs().setZero();
 
     // Compute volumetric integrals and write to the global linear systemz
-    gsVisitorMuscle<T> visitor(*m_pde_ptr,muscleTendon,fiberDir,displacement,pressure);
+    gsVisitorMuscle<T> visitor(*m_pde_ptr,muscleTendon,fiberDir,displacement,pressure,assembleMatrix,
+                               Base::updateElementCache());
     Base::template push<gsVisitorMuscle<T> >(visitor);
     // Compute surface integrals and write to the global rhs vector
     // change to reuse rhs from linear system
     Base::template push<gsVisitorElasticityNeumann<T> >(m_pde_ptr->bc().neumannSides());
 
-    m_system.matrix().makeCompressed();
+    if (assembleMatrix)
+        m_system.matrix().makeCompressed();
 
     return true;
 }
@@ -53,9 +53,20 @@ public:
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDoFs);
 
+    /// Assembles only the residual of Newton's method (in the update form) given the current solution;
+    /// the matrix from the last call to assemble() stays untouched. Falls back to the full assembly
+    /// if the assembly type is not ns_assembly::newton_update.
+    virtual bool assembleResidual(const gsMatrix<T> & solutionVector,
+                                  const std::vector<gsMatrix<T> > & fixedDoFs);
+
+    virtual bool hasResidualAssembly() const
+    { return m_options.getInt("Assembly") == ns_assembly::newton_update; }
+
     /// Assembles the tangential linear system for Newton's method given the current solution
     /// in the form of free and fixed/Dirichelt degrees of freedom.
-    virtual void assemble(const gsMultiPatch<T> & velocity, const gsMultiPatch<T> & pressure);
+    /// set *assembleMatrix* to false to only assemble the residual;
+    virtual void assemble(const gsMultiPatch<T> & velocity, const gsMultiPatch<T> & pressure,
+                          bool assembleMatrix = true);
 
     //--------------------- SOLUTION CONSTRUCTION ----------------------------------//
 
@@ -81,6 +92,14 @@ public:
     virtual gsMatrix<T> computeForce(const gsMultiPatch<T> & velocity, const gsMultiPatch<T> & pressure,
                                      const std::vector<std::pair<index_t,boxSide> > & bdrySides, bool split = false) const;
 
+    /// @brief Assembles the pressure mass matrix, the pressure Laplacian and the pressure convection-diffusion operator
+    /// at the current velocity for Schur complement preconditioners; returns density*viscosity
+    virtual T assembleSchurOperators(const gsMatrix<T> & solutionVector,
+                                     const std::vector<gsMatrix<T> > & fixedDoFs,
+                                     gsSparseMatrix<T> & mass,
+                                     gsSparseMatrix<T> & laplacian,
+                                     gsSparseMatrix<T> & convDiff);
+
 protected:
     /// a custom reserve function to allocate memory for the sparse matrix
     virtual void reserve();
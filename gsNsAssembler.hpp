@@ -54,6 +54,7 @@ gsOptionList gsNsAssembler<T>::defaultOptions()
     opt.addReal("Density","Density of the fluid",1.);
     opt.addReal("ForceScaling","Force scaling parameter",1.);
     opt.addInt("Assembly","Type of the linear system to assemble",ns_assembly::newton_update);
+    opt.addSwitch("EliminationMatrix","Save the elimination matrix (the derivative w.r.t. the Dirichlet DoFs) when assembling Newton's system",false);
     return opt;
 }
 
@@ -100,13 +101,18 @@ template<class T>
 void gsNsAssembler<T>::assemble(bool saveEliminationMatrix)
 {
     m_system.matrix().setZero();
+    Base::eliminationMatrixValid = false;
     reserve();
     m_system.rhs().setZero();
 
-    gsVisitorStokes<T> visitor(*m_pde_ptr);
+    gsSparseEntries<T> elimEntries;
+    gsVisitorStokes<T> visitor(*m_pde_ptr, saveEliminationMatrix ? &elimEntries : nullptr);
     Base::template push<gsVisitorStokes<T> >(visitor);
 
     m_system.matrix().makeCompressed();
+
+    if (saveEliminationMatrix)
+        Base::setEliminationMatrix(elimEntries);
 }
 
 template <class T>
@@ -120,18 +126,59 @@ bool gsNsAssembler<T>::assemble(const gsMatrix<T> & solutionVector,
     return true;
 }
 
+template <class T>
+bool gsNsAssembler<T>::assembleResidual(const gsMatrix<T> & solutionVector,
+                                        const std::vector<gsMatrix<T> > & fixedDoFs)
+{
+    // other assembly types yield a new solution instead of an update; their rhs is not a residual
+    if (m_options.getInt("Assembly") != ns_assembly::newton_update)
+        return assemble(solutionVector,fixedDoFs);
+
+    gsMultiPatch<T> velocity, pressure;
+    constructSolution(solutionVector,fixedDoFs,velocity,pressure);
+    assemble(velocity,pressure,false);
+
+    return true;
+}
+
 template <class T>
 void gsNsAssembler<T>::assemble(const gsMultiPatch<T> & velocity,
-                                const gsMultiPatch<T> & pressure)
+                                const gsMultiPatch<T> & pressure,
+                                bool assembleMatrix)
 {
-    m_system.matrix().setZero();
-    reserve();
+    if (assembleMatrix)
+    {
+        m_system.matrix().setZero();
+        Base::eliminationMatrixValid = false;
+        reserve();
+    }
     m_system.rhs().setZero();
 
-    gsVisitorNavierStokes<T> visitor(*m_pde_ptr,velocity,pressure);
+    const bool saveEliminationMatrix = assembleMatrix && m_options.getSwitch("EliminationMatrix");
+    gsSparseEntries<T> elimEntries;
+    gsVisitorNavierStokes<T> visitor(*m_pde_ptr,velocity,pressure,assembleMatrix,
+                                     saveEliminationMatrix ? &elimEntries : nullptr);
     Base::template push<gsVisitorNavierStokes<T> >(visitor);
 
-    m_system.matrix().makeCompressed();
+    if (assembleMatrix)
+        m_system.matrix().makeCompressed();
+    if (saveEliminationMatrix)
+        Base::setEliminationMatrix(elimEntries);
+}
+
+template <class T>
+T gsNsAssembler<T>::assembleSchurOperators(const gsMatrix<T> & solutionVector,
+                                           const std::vector<gsMatrix<T> > & fixedDoFs,
+                                           gsSparseMatrix<T> & mass,
+                                           gsSparseMatrix<T> & laplacian,
+                                           gsSparseMatrix<T> & convDiff)
+{
+    const T viscosity = m_options.getReal("Viscosity");
+    const T density = m_options.getReal("Density");
+    gsMultiPatch<T> velocity;
+    constructSolution(solutionVector,fixedDoFs,velocity);
+    Base::assemblePressureOperators(mass,&laplacian,&convDiff,&velocity,viscosity,density);
+    return density*viscosity;
 }
 
 //--------------------- SOLUTION CONSTRUCTION ----------------------------------//
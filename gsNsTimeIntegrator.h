@@ -15,6 +15,7 @@
 #pragma once
 
 #include <gsElasticity/gsBaseAssembler.h>
+#include <gsElasticity/gsSparseCombination.h>
 #include <gsElasticity/gsBaseUtils.h>
 
 namespace gismo
@@ -60,10 +61,42 @@ public:
     /// make a time step according to a chosen scheme
     void makeTimeStep(T timeStep);
 
+    /// @brief Make a time step with error control. The local error is estimated by the difference between the solution
+    /// and its linear extrapolation from the previous two time steps, which acts as an embedded lower-order solution.
+    /// Returns true if the step is accepted; otherwise, the state is recovered. In both cases, *nextTimeStep*
+    /// is the proposed size of the next (or the repeated) time step which also accounts for the number of Newton's iterations.
+    /// A step of the minimal size is accepted regardless of the error estimate unless Newton's method fails;
+    /// check solverStatus() if false is returned at the minimal step, since repeating the step will not help.
+    bool makeAdaptiveTimeStep(T timeStep, T & nextTimeStep);
+
+    /** @brief Starts the implicit nonlinear time step without solving it. Forms the part of the right-hand side
+     * given by the solution at the beginning of the time step and the current fixed DoFs of the stiffness assembler.
+     * Then assemble() yields the system of the time step, and an external nonlinear solver (e.g. gsMonolithicFSI)
+     * passes the converged solution to finishTimeStep().
+     */
+    void beginTimeStep(T timeStep);
+
+    /// accept the solution of the time step started by beginTimeStep()
+    void finishTimeStep(const gsMatrix<T> & solutionVector, index_t numIterations);
+
+    /// @brief Derivative of the residual (matrix*solution - rhs) of the last assembled system w.r.t. the fixed DoFs
+    /// of the stiffness assembler. Requires the switch *EliminationMatrix* of the stiffness assembler.
+    void dirichletJacobian(gsSparseMatrix<T> & result) const;
+
     /// assemble the linear system for the nonlinear solver
     virtual bool assemble(const gsMatrix<T> & solutionVector,
                           const std::vector<gsMatrix<T> > & fixedDoFs);
 
+    /// pressure operators of the stiffness assembler scaled to the Schur complement of the time-discrete system
+    virtual T assembleSchurOperators(const gsMatrix<T> & solutionVector,
+                                     const std::vector<gsMatrix<T> > & fixedDoFs,
+                                     gsSparseMatrix<T> & mass,
+                                     gsSparseMatrix<T> & laplacian,
+                                     gsSparseMatrix<T> & convDiff);
+
+    /// block structure of the stiffness assembler
+    virtual std::vector<index_t> freeBlockSizes() const { return stiffAssembler.freeBlockSizes(); }
+
     /// returns number of degrees of freedom
     virtual int numDofs() const { return stiffAssembler.numDofs(); }
 
@@ -84,9 +117,16 @@ public:
     /// number of iterations Newton's method required at the last time step; always 1 for IMEX
     index_t numberIterations() const { return numIters;}
 
+    /// status of Newton's method at the last time step; always converged for IMEX
+    solver_status solverStatus() const { return newtonStatus; }
+
     /// construct the solution using the stiffness matrix assembler
     void constructSolution(gsMultiPatch<T> & velocity, gsMultiPatch<T> & pressure) const;
 
+    /// construct the solution from a given solution vector and the current fixed DoFs of the stiffness assembler
+    void constructSolution(const gsMatrix<T> & solutionVector,
+                           gsMultiPatch<T> & velocity, gsMultiPatch<T> & pressure) const;
+
     /// assemblers' accessors
     gsBaseAssembler<T> & mAssembler();
     gsBaseAssembler<T> & assembler();
@@ -100,6 +140,8 @@ protected:
     /// time integraton schemes
     void implicitLinear();
     void implicitNonlinear();
+    /// part of the rhs of the implicit nonlinear scheme that does not change during Newton's iterations
+    void formConstRHS();
 
 protected:
     /// assembler object that generates the static system
@@ -123,6 +165,11 @@ protected:
     /// Newton stuff
     gsMatrix<T> constRHS;
     index_t numIters;
+    solver_status newtonStatus;
+
+    /// adaptive time stepping: last accepted time step and the solution before it
+    T adaptOldTimeStep;
+    gsMatrix<T> adaptOldSolVector;
 
     /// ALE velocity
     gsMultiPatch<T> * velocityALE;
@@ -133,10 +180,14 @@ protected:
     bool hasSavedState;
     gsMatrix<T> velVecSaved;
     gsMatrix<T> oldVecSaved;
+    T oldTimeStepSaved;
     gsMatrix<T> massRhsSaved;
     gsMatrix<T> stiffRhsSaved;
     gsSparseMatrix<T> stiffMatrixSaved;
     std::vector<gsMatrix<T> > ddofsSaved;
+
+    /// in-place combination M + dt*theta*A with a fixed sparsity pattern
+    gsSparseCombination<T> matCombination;
 };
 
 }
@@ -38,6 +38,8 @@ gsNsTimeIntegrator<T>::gsNsTimeIntegrator(gsNsAssembler<T> & stiffAssembler_,
     m_options = defaultOptions();
     m_ddof = stiffAssembler.allFixedDofs();
     numIters = 0;
+    newtonStatus = solver_status::converged;
+    adaptOldTimeStep = 0.;
     hasSavedState = false;
 }
 
@@ -51,6 +53,16 @@ gsOptionList gsNsTimeIntegrator<T>::defaultOptions()
     opt.addReal("AbsTol","Absolute tolerance for the convergence cretiria",1e-10);
     opt.addReal("RelTol","Relative tolerance for the stopping criteria",1e-7);
     opt.addSwitch("ALE","ALE deformation is applied to the flow domain",false);
+    /// linear solver for Newton's method, see gsIterative
+    opt.addInt("Solver","Linear solver to use",linear_solver::LU);
+    opt.addInt("Precond","Preconditioner for the Krylov solvers",linear_precond::block_triangular);
+    opt.addInt("SchurApprox","Schur complement approximation of the block-triangular preconditioner",schur_approx::PCD);
+    /// adaptive time stepping
+    opt.addReal("ErrRelTol","Relative tolerance for the local time error in adaptive time stepping",1e-3);
+    opt.addReal("ErrAbsTol","Absolute tolerance for the local time error in adaptive time stepping",1e-10);
+    opt.addReal("MinTimeStep","Minimal time step in adaptive time stepping",1e-8);
+    opt.addReal("MaxTimeStep","Maximal time step in adaptive time stepping",1e8);
+    opt.addInt("TargetIters","Adaptive time stepping reduces the time step if Newton's method needs more iterations",8);
     return opt;
 }
 
@@ -59,8 +71,11 @@ void gsNsTimeIntegrator<T>::initialize()
 {
     GISMO_ENSURE(solVector.rows() == stiffAssembler.numDofs(),"No initial conditions provided!");
     stiffAssembler.assemble(solVector,m_ddof);
-    massAssembler.setFixedDofs(m_ddof);
+    // assemble with homogeneous Dirichlet DoFs so that the saved rhs contains no Dirichlet contribution
+    massAssembler.homogenizeFixedDofs(-1);
     massAssembler.assemble(true);
+    massAssembler.setFixedDofs(m_ddof);
+    massAssembler.eliminateFixedDofs();
     // IMEX stuff
     oldSolVector = solVector;
     oldTimeStep = 1.;
@@ -75,12 +90,53 @@ void gsNsTimeIntegrator<T>::makeTimeStep(T timeStep)
         initialize();
 
     tStep = timeStep;
+    newtonStatus = solver_status::converged;
     if (m_options.getInt("Scheme") == time_integration::implicit_nonlinear)
         implicitNonlinear();
     if (m_options.getInt("Scheme") == time_integration::implicit_linear)
         implicitLinear();
 }
 
+template <class T>
+bool gsNsTimeIntegrator<T>::makeAdaptiveTimeStep(T timeStep, T & nextTimeStep)
+{
+    const T minStep = m_options.getReal("MinTimeStep");
+    const index_t numDofsVel = massAssembler.numDofs();
+    saveState();
+    const gsMatrix<T> oldSol = solVector;
+    makeTimeStep(timeStep);
+
+    if (newtonStatus != solver_status::converged)
+    {   // Newton's method failed: repeat with a smaller step; at the minimal step, the failure
+        // is reported by solverStatus() and the state stays at the beginning of the time step
+        recoverState();
+        nextTimeStep = math::max(timeStep/2,minStep);
+        return false;
+    }
+
+    T error = 0.;
+    if (adaptOldTimeStep > 0.)
+    {   // difference to the linear extrapolation u_n + dt/dt_old*(u_n - u_n-1) in the velocity DoFs
+        const T errNorm = (solVector - oldSol - timeStep/adaptOldTimeStep*(oldSol - adaptOldSolVector)).middleRows(0,numDofsVel).norm();
+        error = errNorm/(m_options.getReal("ErrAbsTol") +
+                         m_options.getReal("ErrRelTol")*solVector.middleRows(0,numDofsVel).norm());
+    }
+    // the estimate is of order 2 in dt; without history, the time step can only be reduced by Newton's method
+    T factor = timeStepFactor<T>(error,2,numIters,m_options.getInt("TargetIters"));
+    if (adaptOldTimeStep == 0.)
+        factor = math::min(factor,(T)1.);
+    nextTimeStep = timeStep*factor;
+    nextTimeStep = math::min(math::max(nextTimeStep,minStep),m_options.getReal("MaxTimeStep"));
+    if (error > 1. && timeStep > minStep)
+    {
+        recoverState();
+        return false;
+    }
+    adaptOldSolVector = oldSol;
+    adaptOldTimeStep = timeStep;
+    return true;
+}
+
 template <class T>
 void gsNsTimeIntegrator<T>::implicitLinear()
 {
@@ -119,17 +175,8 @@ void gsNsTimeIntegrator<T>::implicitLinear()
     m_system.rhs() += tStep*theta*stiffAssembler.rhs();
     // rhs: -M_FD*u_DDOFS_n+1
     m_system.rhs().middleRows(0,numDofsVel) += massAssembler.rhs();
-    // matrix = M + dt*theta*A(u_exp)
-    m_system.matrix() = tStep*stiffAssembler.matrix();
-    // we need to modify the (0,0,numDofsVel,numDofsVel) block of the matrix.
-    // unfortunately, eigen provides only a read-only block interfaces.
-    // the following is an ugly way to overcome this
-    gsSparseMatrix<T> tempVelocityBlock = m_system.matrix().block(0,0,numDofsVel,numDofsVel);
-    tempVelocityBlock *= (theta-1);
-    tempVelocityBlock += massAssembler.matrix();
-    tempVelocityBlock.conservativeResize(stiffAssembler.numDofs(),numDofsVel);
-    m_system.matrix().leftCols(numDofsVel) += tempVelocityBlock;
-    m_system.matrix().makeCompressed();
+    // matrix = M + dt*theta*A(u_exp) in the velocity block, dt*A(u_exp) elsewhere
+    matCombination.compute(stiffAssembler.matrix(),tStep,tStep*theta,massAssembler.matrix(),1.,m_system.matrix());
 
     oldSolVector = solVector;
     oldTimeStep = tStep;
@@ -146,7 +193,7 @@ void gsNsTimeIntegrator<T>::implicitLinear()
 }
 
 template <class T>
-void gsNsTimeIntegrator<T>::implicitNonlinear()
+void gsNsTimeIntegrator<T>::formConstRHS()
 {
     stiffAssembler.options().setInt("Assembly",ns_assembly::newton_next);
     T theta = m_options.getReal("Theta");
@@ -158,22 +205,61 @@ void gsNsTimeIntegrator<T>::implicitNonlinear()
     constRHS.middleRows(0,numDofsVel).noalias() -= massAssembler.rhs();
     massAssembler.setFixedDofs(stiffAssembler.allFixedDofs());
     if (m_options.getSwitch("ALE"))
-        massAssembler.assemble();
+        massAssembler.assemble(stiffAssembler.options().getSwitch("EliminationMatrix"));
     else
         massAssembler.eliminateFixedDofs();
     constRHS.middleRows(0,numDofsVel).noalias() += massAssembler.rhs();
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::implicitNonlinear()
+{
+    formConstRHS();
 
     gsIterative<T> solver(*this,solVector,m_ddof);
     solver.options().setInt("Verbosity",m_options.getInt("Verbosity"));
-    solver.options().setInt("Solver",linear_solver::LU);
+    solver.options().setInt("Solver",m_options.getInt("Solver"));
+    solver.options().setInt("Precond",m_options.getInt("Precond"));
+    solver.options().setInt("SchurApprox",m_options.getInt("SchurApprox"));
     solver.options().setInt("IterType",iteration_type::next);
     solver.options().setReal("AbsTol",m_options.getReal("AbsTol"));
     solver.options().setReal("RelTol",m_options.getReal("RelTol"));
     solver.solve();
 
-    solVector = solver.solution();
+    finishTimeStep(solver.solution(),solver.numberIterations());
+    newtonStatus = solver.solverStatus();
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::beginTimeStep(T timeStep)
+{
+    if (!initialized)
+        initialize();
+
+    tStep = timeStep;
+    newtonStatus = solver_status::converged;
+    formConstRHS();
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::finishTimeStep(const gsMatrix<T> & solutionVector, index_t numIterations)
+{
+    GISMO_ENSURE(solutionVector.rows() == stiffAssembler.numDofs(),"Wrong size of the solution vector: " + util::to_string(solutionVector.rows()) +
+                 ". Must be: " + util::to_string(stiffAssembler.numDofs()));
+    solVector = solutionVector;
     m_ddof = stiffAssembler.allFixedDofs();
-    numIters = solver.numberIterations();
+    numIters = numIterations;
+}
+
+template <class T>
+void gsNsTimeIntegrator<T>::dirichletJacobian(gsSparseMatrix<T> & result) const
+{
+    GISMO_ENSURE(stiffAssembler.hasEliminationMatrix() && massAssembler.hasEliminationMatrix(),
+                 "No elimination matrices available. Set the switch EliminationMatrix of the stiffness assembler.");
+    // the rhs is dt*theta*F(u) + constRHS, and constRHS contains -M_FD*u_DDOFS_n+1 in the velocity block
+    gsSparseMatrix<T> massPart = massAssembler.getEliminationMatrix();
+    massPart.conservativeResize(stiffAssembler.numDofs(),stiffAssembler.numFixedDofs());
+    result = tStep*m_options.getReal("Theta")*stiffAssembler.getEliminationMatrix() + massPart;
 }
 
 template <class T>
@@ -190,25 +276,41 @@ bool gsNsTimeIntegrator<T>::assemble(const gsMatrix<T> & solutionVector,
                     velocityALE->patch(interface->patches[p].first).coefs();
     stiffAssembler.assemble(velocity,pressure);
 
-    m_system.matrix() = tStep*stiffAssembler.matrix();
-    index_t numDofsVel = massAssembler.numDofs();
-    gsSparseMatrix<T> tempVelocityBlock = m_system.matrix().block(0,0,numDofsVel,numDofsVel);
-    tempVelocityBlock *= (theta-1);
-    tempVelocityBlock += massAssembler.matrix();
-    tempVelocityBlock.conservativeResize(stiffAssembler.numDofs(),numDofsVel);
-    m_system.matrix().leftCols(numDofsVel) += tempVelocityBlock;
-    m_system.matrix().makeCompressed();
+    // matrix = M + dt*theta*A(u) in the velocity block, dt*A(u) elsewhere
+    matCombination.compute(stiffAssembler.matrix(),tStep,tStep*theta,massAssembler.matrix(),1.,m_system.matrix());
 
     m_system.rhs() = tStep*theta*stiffAssembler.rhs() + constRHS;
     return true;
 }
 
+template <class T>
+T gsNsTimeIntegrator<T>::assembleSchurOperators(const gsMatrix<T> & solutionVector,
+                                                const std::vector<gsMatrix<T> > & fixedDoFs,
+                                                gsSparseMatrix<T> & mass,
+                                                gsSparseMatrix<T> & laplacian,
+                                                gsSparseMatrix<T> & convDiff)
+{
+    const T theta = m_options.getReal("Theta");
+    const T density = stiffAssembler.options().getReal("Density");
+    const T coef = stiffAssembler.assembleSchurOperators(solutionVector,fixedDoFs,mass,laplacian,convDiff);
+    // the system matrix is M + dt*theta*A in the velocity block and dt*A in the coupling blocks
+    convDiff = (density*mass + tStep*theta*convDiff)/(tStep*tStep);
+    return coef*theta/tStep;
+}
+
 template <class T>
 void gsNsTimeIntegrator<T>::constructSolution(gsMultiPatch<T> & velocity, gsMultiPatch<T> & pressure) const
 {
     stiffAssembler.constructSolution(solVector,m_ddof,velocity,pressure);
 }
 
+template <class T>
+void gsNsTimeIntegrator<T>::constructSolution(const gsMatrix<T> & solutionVector,
+                                              gsMultiPatch<T> & velocity, gsMultiPatch<T> & pressure) const
+{
+    stiffAssembler.constructSolution(solutionVector,stiffAssembler.allFixedDofs(),velocity,pressure);
+}
+
 template <class T>
 gsBaseAssembler<T> & gsNsTimeIntegrator<T>::mAssembler() { return massAssembler; }
 
@@ -223,6 +325,7 @@ void gsNsTimeIntegrator<T>::saveState()
 
     velVecSaved = solVector;
     oldVecSaved = oldSolVector;
+    oldTimeStepSaved = oldTimeStep;
     massRhsSaved = massAssembler.rhs();
     stiffRhsSaved = stiffAssembler.rhs();
     stiffMatrixSaved = stiffAssembler.matrix();
@@ -236,6 +339,7 @@ void gsNsTimeIntegrator<T>::recoverState()
     GISMO_ENSURE(hasSavedState,"No state saved!");
     solVector = velVecSaved;
     oldSolVector = oldVecSaved;
+    oldTimeStep = oldTimeStepSaved;
     massAssembler.setRHS(massRhsSaved);
     stiffAssembler.setMatrix(stiffMatrixSaved);
     stiffAssembler.setRHS(stiffRhsSaved);
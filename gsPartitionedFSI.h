@@ -15,6 +15,7 @@
 #pragma once
 
 #include <gsIO/gsOptionList.h>
+#include <deque>
 
 namespace gismo
 {
@@ -28,6 +29,14 @@ class gsALE;
 template <class T>
 class gsMultiPatch;
 
+/** @brief Partitioned FSI solver: the structure, the ALE mesh and the flow are solved one after another
+ * in coupling iterations accelerated by Aitken's relaxation or by interface quasi-Newton methods.
+ *
+ * With the switch *Jacobi*, the structure and the flow (with the ALE mesh) are solved concurrently,
+ * each on its own share of threads, using the interface displacement and the flow solution of the previous iteration.
+ * The acceleration then acts on the stacked vector of the interface displacement and the flow solution,
+ * both parts scaled by their initial residuals.
+ */
 template <class T>
 class gsPartitionedFSI
 {
@@ -52,10 +61,17 @@ public:
     /// form a residual vector
     void formVector(const gsMultiPatch<T> & disp, gsMatrix<T> & vector);
 
+    /// write an interface vector back to the interface DoFs of a displacement field; inverse of formVector
+    void setVector(const gsMatrix<T> & vector, gsMultiPatch<T> & disp);
+
     /// perform Aitken relaxation step
     void aitken(gsMultiPatch<T> & dispA, gsMultiPatch<T> & dispB,
                 gsMultiPatch<T> & dispB2, gsMultiPatch<T> & dispC);
 
+    /// perform interface quasi-Newton step (IQN-ILS or IQN-IMVJ) given the new structure solution;
+    /// the interface DoFs of the solution are replaced by the next interface guess
+    void quasiNewton(gsMultiPatch<T> & disp);
+
     /// number of iterations the solver took to converge at the last time step
     index_t numberIterations() { return numIter; }
     /// amount of time consumed by each component at the last time step
@@ -69,6 +85,32 @@ public:
     /// FSI interface relative residual norm
     T residualNormRel() { return absResNorm/initResNorm; }
 
+protected:
+    /// coupling iterations of the Jacobi scheme, see the switch *Jacobi*
+    bool makeTimeStepJacobi(T timeStep);
+
+    /// moves the flow mesh according to the current displacement and writes the new ALE displacement to *aleDisplacement*;
+    /// returns false if the ALE deformation is not bijective
+    bool moveMesh(T timeStep, bool recover, gsMultiPatch<T> & aleDisplacement);
+
+    /// sets the interface velocity from the ALE velocity and makes the time step of the flow
+    void flowStep(T timeStep, bool recover);
+
+    /// interface quasi-Newton update for a given output and residual; *newPair* adds the secant pair
+    /// formed with the previous iteration
+    void quasiNewtonStep(const gsMatrix<T> & output, const gsMatrix<T> & residual,
+                         bool newPair, gsMatrix<T> & nextInput);
+
+    /// removes secant pairs (columns of V and W) whose residual differences are nearly linearly dependent
+    /// on newer ones (QR1 filter); the newest pairs come first
+    void filterColumns(gsMatrix<T> & V, gsMatrix<T> & W) const;
+
+    /// stores the secant pairs of the time step for IQN-ILS or updates the inverse Jacobian for IQN-IMVJ
+    void finalizeQuasiNewton();
+
+    /// appends the columns of B to A
+    static void appendColumns(gsMatrix<T> & A, const gsMatrix<T> & B);
+
 protected:
     /// component solvers
     gsNsTimeIntegrator<T> & m_nsSolver;
@@ -87,6 +129,11 @@ protected:
     T nsTime, elTime, aleTime; // component computational times
     T omega; // aitken relaxation parameter
     T absResNorm, initResNorm; // residual norms for convergence cretirion
+    /// interface quasi-Newton data
+    gsMatrix<T> iqnInput, iqnOutput, iqnResidual; // interface input, output and residual of the last iteration
+    gsMatrix<T> iqnV, iqnW; // differences of residuals and of outputs at the current time step, newest first
+    std::deque<std::pair<gsMatrix<T>,gsMatrix<T> > > iqnHistory; // IQN-ILS: V and W of previous time steps, newest first
+    gsMatrix<T> iqnJacobian; // IQN-IMVJ: inverse Jacobian accumulated over previous time steps
 
 };
 
@@ -53,12 +53,20 @@ gsOptionList gsPartitionedFSI<T>::defaultOptions()
     opt.addReal("AbsTol","Absolute tolerance for the convergence creterion",1e-10);
     opt.addReal("RelTol","Absolute tolerance for the convergence creterion",1e-6);
     opt.addInt("Verbosity","Amount of information printed to the terminal: none, some, all",solver_verbosity::none);
+    opt.addInt("Acceleration","Acceleration of the coupling iterations: aitken, IQN_ILS, IQN_IMVJ",coupling_acceleration::aitken);
+    opt.addInt("IQNReuse","Number of previous time steps whose secant pairs are reused by IQN-ILS",0);
+    opt.addReal("IQNFilter","Tolerance of the QR filter which removes nearly linearly dependent secant pairs",1e-8);
+    opt.addSwitch("Jacobi","Jacobi coupling: the flow (with ALE) and the structure are solved concurrently using the previous iterate",false);
+    opt.addInt("FlowThreads","Number of threads for the flow and ALE solvers in the Jacobi coupling; 0 - half of the threads",0);
     return opt;
 }
 
 template <class T>
 bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
 {
+    if (m_options.getSwitch("Jacobi"))
+        return makeTimeStepJacobi(timeStep);
+
     // save states of the component solvers at the beginning of the time step
     m_nsSolver.saveState();
     m_elSolver.saveState();
@@ -68,6 +76,9 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
     numIter = 0;
     converged = false;
     omega = 1.;
+    const index_t acceleration = m_options.getInt("Acceleration");
+    iqnV.resize(0,0);
+    iqnW.resize(0,0);
 
     // reset time profiling info
     gsStopwatch clock;
@@ -88,6 +99,13 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
         {
             m_elSolver.constructSolution(dispOldOld);
             m_elSolver.constructSolution(m_displacement);
+            if (acceleration != coupling_acceleration::aitken)
+                formVector(m_displacement,iqnInput);
+        }
+        else if (acceleration != coupling_acceleration::aitken) // interface quasi-Newton step
+        {
+            m_elSolver.constructSolution(m_displacement);
+            quasiNewton(m_displacement);
         }
         else if (numIter == 1) // save displacement i-1 as a guess and a corrected solution
         {
@@ -115,61 +133,16 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
 
         // ============= Flow mesh/ALE section ===================== //
         clock.restart();
-        // recover ALE at the start of timestep
-        if (numIter > 0)
-            m_aleSolver.recoverState();
-
-        // undo last ALE deformation of the flow domain
-        for (index_t p = 0; p < m_nsSolver.aleInterface().patches.size(); ++p)
-        {
-            index_t pFlow = m_nsSolver.aleInterface().patches[p].second;
-            index_t pALE = m_nsSolver.aleInterface().patches[p].first;
-            m_nsSolver.assembler().patches().patch(pFlow).coefs() -= m_ALEdisplacment.patch(pALE).coefs();
-            m_nsSolver.mAssembler().patches().patch(pFlow).coefs() -= m_ALEdisplacment.patch(pALE).coefs();
-        }
-
-        // save ALE displacement at the beginning of the time step for ALE velocity computation
-        m_aleSolver.constructSolution(m_ALEvelocity);
-        // update ALE
-        if (m_aleSolver.updateMesh() != -1)
+        if (!moveMesh(timeStep,numIter > 0,m_ALEdisplacment))
             return false; // if the new ALE deformation is not bijective, stop the simulation
-        // construct new ALE displacement
-        m_aleSolver.constructSolution(m_ALEdisplacment);
-        for (index_t p = 0; p < m_ALEvelocity.nPatches(); ++p)
-            m_ALEvelocity.patch(p).coefs() = (m_ALEdisplacment.patch(p).coefs() - m_ALEvelocity.patch(p).coefs()) / timeStep;
-
-        // apply new ALE deformation to the flow domain
-        for (index_t p = 0; p < m_nsSolver.aleInterface().patches.size(); ++p)
-        {
-            index_t pFlow = m_nsSolver.aleInterface().patches[p].second;
-            index_t pALE = m_nsSolver.aleInterface().patches[p].first;
-            m_nsSolver.assembler().patches().patch(pFlow).coefs() += m_ALEdisplacment.patch(pALE).coefs();
-            m_nsSolver.mAssembler().patches().patch(pFlow).coefs() += m_ALEdisplacment.patch(pALE).coefs();
-        }
-
         aleTime += clock.stop();
         // =================================================================== //
 
 
         // ======================= Flow section ============================== //
         clock.restart();
-        if (numIter > 0) // recover the solver state from the time step beginning
-            m_nsSolver.recoverState();
-
-        // set velocity boundary condition on the FSI interface; velocity comes from the ALE velocity;
-        // FSI inteface info is contained in the Navier-Stokes solver
-        for (index_t p = 0; p < m_nsSolver.aleInterface().sidesA.size(); ++p)
-        {
-            index_t pFlow = m_nsSolver.aleInterface().sidesB[p].patch;
-            boxSide sFlow = m_nsSolver.aleInterface().sidesB[p].side();
-            index_t pALE = m_nsSolver.aleInterface().sidesA[p].patch;
-            boxSide sALE = m_nsSolver.aleInterface().sidesA[p].side();
-            m_nsSolver.assembler().setFixedDofs(pFlow,sFlow,m_ALEvelocity.patch(pALE).boundary(sALE)->coefs());
-        }
-
-        m_nsSolver.makeTimeStep(timeStep);
+        flowStep(timeStep,numIter > 0);
         m_nsSolver.constructSolution(m_velocity,m_pressure);
-
         nsTime += clock.stop();
         // =================================================================== //
 
@@ -177,6 +150,168 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
         ++numIter;
     }
 
+    if (acceleration != coupling_acceleration::aitken)
+        finalizeQuasiNewton();
+
+    if (m_options.getInt("Verbosity") != solver_verbosity::none && numIter > 1)
+    {
+        if (converged)
+            gsInfo << "Converged after " << numIter << " iters, absRes "
+                   << absResNorm << ", relRes " << absResNorm/initResNorm << std::endl;
+        else
+            gsInfo << "Terminated after " << numIter << " iters, absRes "
+                   << absResNorm << ", relRes " << absResNorm/initResNorm << std::endl;
+    }
+
+    return true;
+}
+
+template <class T>
+bool gsPartitionedFSI<T>::makeTimeStepJacobi(T timeStep)
+{
+    const index_t acceleration = m_options.getInt("Acceleration");
+    GISMO_ENSURE(acceleration != coupling_acceleration::IQN_IMVJ,
+                 "IQN-IMVJ is not available for the Jacobi coupling: its inverse Jacobian would be dense in all flow DoFs");
+
+    // save states of the component solvers at the beginning of the time step
+    m_nsSolver.saveState();
+    m_elSolver.saveState();
+    m_aleSolver.saveState();
+
+    // reset the solver
+    numIter = 0;
+    converged = false;
+    omega = 1.;
+    iqnV.resize(0,0);
+    iqnW.resize(0,0);
+    nsTime = elTime = aleTime = 0.;
+
+    // distribute the threads between the two branches
+    int flowThreads = 1, solidThreads = 1;
+#ifdef _OPENMP
+    const int nt = omp_get_max_threads();
+    flowThreads = m_options.getInt("FlowThreads") > 0 ? m_options.getInt("FlowThreads") : nt/2;
+    flowThreads = math::max(1,math::min(flowThreads,nt-1));
+    solidThreads = math::max(1,nt-flowThreads);
+    // the assemblers of each branch run their own parallel regions
+    const int activeLevels = omp_get_max_active_levels();
+    omp_set_max_active_levels(math::max(activeLevels,2));
+#endif
+
+    // both branches read the input of the iteration, so the new ALE displacement is written to a buffer
+    gsMultiPatch<T> aleDispNew(m_ALEdisplacment);
+    // input of the iteration: interface displacement and flow solution
+    gsMatrix<T> dispInput, flowInput, dispOutput, flowOutput;
+    formVector(m_displacement,dispInput);
+    flowInput = m_nsSolver.solutionVector();
+    // scaling of the stacked interface vector and initial residual norms
+    T dispScale = 1., flowScale = 1., initFlowNorm = 0.;
+    bool aleValid = true;
+
+    while (numIter < m_options.getInt("MaxIter") && !converged)
+    {
+        const bool recover = numIter > 0;
+#pragma omp parallel sections num_threads(2)
+        {
+#pragma omp section
+            {   // ================== Structure section ================ //
+#ifdef _OPENMP
+                omp_set_num_threads(solidThreads);
+#endif
+                gsStopwatch clockEL;
+                if (recover)
+                    m_elSolver.recoverState();
+                m_elSolver.makeTimeStep(timeStep);
+                elTime += clockEL.stop();
+            }
+#pragma omp section
+            {   // ============= Flow mesh/ALE and flow section ============= //
+#ifdef _OPENMP
+                omp_set_num_threads(flowThreads);
+#endif
+                gsStopwatch clockFlow;
+                aleValid = moveMesh(timeStep,recover,aleDispNew);
+                aleTime += clockFlow.stop();
+                if (aleValid)
+                {
+                    clockFlow.restart();
+                    flowStep(timeStep,recover);
+                    nsTime += clockFlow.stop();
+                }
+            }
+        }
+        if (!aleValid)
+            break; // if the new ALE deformation is not bijective, stop the simulation
+        for (index_t p = 0; p < m_ALEdisplacment.nPatches(); ++p)
+            m_ALEdisplacment.patch(p).coefs() = aleDispNew.patch(p).coefs();
+
+        // residuals of the structure and of the flow parts
+        m_elSolver.constructSolution(m_displacement);
+        formVector(m_displacement,dispOutput);
+        flowOutput = m_nsSolver.solutionVector();
+        const T dispNorm = (dispOutput-dispInput).norm();
+        const T flowNorm = (flowOutput-flowInput).norm();
+        absResNorm = dispNorm/sqrt(dispOutput.rows());
+        if (numIter == 0)
+        {
+            initResNorm = absResNorm;
+            initFlowNorm = flowNorm/sqrt(flowOutput.rows());
+            // both parts of the stacked vector are scaled by their initial residuals
+            dispScale = dispNorm > 0. ? 1./dispNorm : 1.;
+            flowScale = flowNorm > 0. ? 1./flowNorm : 1.;
+        }
+        const T flowResNorm = flowNorm/sqrt(flowOutput.rows());
+        converged = numIter > 0 &&
+                    (absResNorm < m_options.getReal("AbsTol") || absResNorm/initResNorm < m_options.getReal("RelTol")) &&
+                    (flowResNorm < m_options.getReal("AbsTol") || flowResNorm/initFlowNorm < m_options.getReal("RelTol"));
+        if (numIter > 0 && m_options.getInt("Verbosity") == solver_verbosity::all)
+            gsInfo << numIter << ": absRes " << absResNorm << ", relRes " << absResNorm/initResNorm
+                   << ", flow relRes " << flowResNorm/initFlowNorm << std::endl;
+
+        if (converged)
+        {   // the outputs are the solution
+            m_nsSolver.constructSolution(m_velocity,m_pressure);
+        }
+        else
+        {   // acceleration of the stacked interface vector
+            const index_t numDisp = dispOutput.rows();
+            gsMatrix<T> input(numDisp+flowInput.rows(),1), output(numDisp+flowOutput.rows(),1), nextInput;
+            input.topRows(numDisp) = dispScale*dispInput;
+            input.bottomRows(flowInput.rows()) = flowScale*flowInput;
+            output.topRows(numDisp) = dispScale*dispOutput;
+            output.bottomRows(flowOutput.rows()) = flowScale*flowOutput;
+            const gsMatrix<T> residual = output - input;
+            if (acceleration == coupling_acceleration::aitken)
+            {
+                if (numIter > 0)
+                {
+                    const gsMatrix<T> resDiff = residual - iqnResidual;
+                    omega = -1*omega * (iqnResidual.transpose()*resDiff)(0,0) / (resDiff.transpose()*resDiff)(0,0);
+                }
+                iqnResidual = residual;
+                nextInput = input + omega*residual;
+            }
+            else
+                quasiNewtonStep(output,residual,numIter > 0,nextInput);
+
+            dispInput = nextInput.topRows(numDisp)/dispScale;
+            flowInput = nextInput.bottomRows(flowInput.rows())/flowScale;
+            setVector(dispInput,m_displacement);
+            m_nsSolver.constructSolution(flowInput,m_velocity,m_pressure);
+        }
+
+        ++numIter;
+    }
+
+#ifdef _OPENMP
+    omp_set_max_active_levels(activeLevels);
+#endif
+    if (!aleValid)
+        return false;
+
+    if (acceleration != coupling_acceleration::aitken)
+        finalizeQuasiNewton();
+
     if (m_options.getInt("Verbosity") != solver_verbosity::none && numIter > 1)
     {
         if (converged)
@@ -190,6 +325,63 @@ bool gsPartitionedFSI<T>::makeTimeStep(T timeStep)
     return true;
 }
 
+template <class T>
+bool gsPartitionedFSI<T>::moveMesh(T timeStep, bool recover, gsMultiPatch<T> & aleDisplacement)
+{
+    // recover ALE at the start of timestep
+    if (recover)
+        m_aleSolver.recoverState();
+
+    // undo last ALE deformation of the flow domain
+    for (index_t p = 0; p < m_nsSolver.aleInterface().patches.size(); ++p)
+    {
+        index_t pFlow = m_nsSolver.aleInterface().patches[p].second;
+        index_t pALE = m_nsSolver.aleInterface().patches[p].first;
+        m_nsSolver.assembler().patches().patch(pFlow).coefs() -= m_ALEdisplacment.patch(pALE).coefs();
+        m_nsSolver.mAssembler().patches().patch(pFlow).coefs() -= m_ALEdisplacment.patch(pALE).coefs();
+    }
+
+    // save ALE displacement at the beginning of the time step for ALE velocity computation
+    m_aleSolver.constructSolution(m_ALEvelocity);
+    // update ALE
+    if (m_aleSolver.updateMesh() != -1)
+        return false;
+    // construct new ALE displacement
+    m_aleSolver.constructSolution(aleDisplacement);
+    for (index_t p = 0; p < m_ALEvelocity.nPatches(); ++p)
+        m_ALEvelocity.patch(p).coefs() = (aleDisplacement.patch(p).coefs() - m_ALEvelocity.patch(p).coefs()) / timeStep;
+
+    // apply new ALE deformation to the flow domain
+    for (index_t p = 0; p < m_nsSolver.aleInterface().patches.size(); ++p)
+    {
+        index_t pFlow = m_nsSolver.aleInterface().patches[p].second;
+        index_t pALE = m_nsSolver.aleInterface().patches[p].first;
+        m_nsSolver.assembler().patches().patch(pFlow).coefs() += aleDisplacement.patch(pALE).coefs();
+        m_nsSolver.mAssembler().patches().patch(pFlow).coefs() += aleDisplacement.patch(pALE).coefs();
+    }
+    return true;
+}
+
+template <class T>
+void gsPartitionedFSI<T>::flowStep(T timeStep, bool recover)
+{
+    if (recover) // recover the solver state from the time step beginning
+        m_nsSolver.recoverState();
+
+    // set velocity boundary condition on the FSI interface; velocity comes from the ALE velocity;
+    // FSI inteface info is contained in the Navier-Stokes solver
+    for (index_t p = 0; p < m_nsSolver.aleInterface().sidesA.size(); ++p)
+    {
+        index_t pFlow = m_nsSolver.aleInterface().sidesB[p].patch;
+        boxSide sFlow = m_nsSolver.aleInterface().sidesB[p].side();
+        index_t pALE = m_nsSolver.aleInterface().sidesA[p].patch;
+        boxSide sALE = m_nsSolver.aleInterface().sidesA[p].side();
+        m_nsSolver.assembler().setFixedDofs(pFlow,sFlow,m_ALEvelocity.patch(pALE).boundary(sALE)->coefs());
+    }
+
+    m_nsSolver.makeTimeStep(timeStep);
+}
+
 template <class T>
 void gsPartitionedFSI<T>::formVector(const gsMultiPatch<T> & disp, gsMatrix<T> & vector)
 {
@@ -218,6 +410,26 @@ void gsPartitionedFSI<T>::formVector(const gsMultiPatch<T> & disp, gsMatrix<T> &
     }
 }
 
+template <class T>
+void gsPartitionedFSI<T>::setVector(const gsMatrix<T> & vector, gsMultiPatch<T> & disp)
+{
+    index_t dim = disp.patch(0).parDim();
+
+    index_t filledSize = 0;
+    for (index_t i = 0; i < m_aleSolver.interface().sidesA.size(); ++i)
+    {
+        index_t patch = m_aleSolver.interface().sidesA[i].patch;
+        boxSide side = m_aleSolver.interface().sidesA[i].side();
+        gsMatrix<index_t> bdryIndices = disp.patch(patch).basis().boundary(side);
+        for (index_t d = 0; d < dim;++d)
+        {
+            for (index_t j = 0; j < bdryIndices.rows(); ++j)
+                disp.patch(patch).coefs()(bdryIndices(j,0),d) = vector(filledSize+j,0);
+            filledSize += bdryIndices.rows();
+        }
+    }
+}
+
 template <class T>
 void gsPartitionedFSI<T>::aitken(gsMultiPatch<T> & dispOO, gsMultiPatch<T> & dispOG,
                                  gsMultiPatch<T> & dispO, gsMultiPatch<T> & dispN)
@@ -246,4 +458,146 @@ void gsPartitionedFSI<T>::aitken(gsMultiPatch<T> & dispOO, gsMultiPatch<T> & dis
         converged = true;
 }
 
+template <class T>
+void gsPartitionedFSI<T>::quasiNewton(gsMultiPatch<T> & disp)
+{
+    gsMatrix<T> output;
+    formVector(disp,output);
+    gsMatrix<T> residual = output - iqnInput;
+
+    absResNorm = residual.norm()/sqrt(residual.rows());
+    if (numIter == 1)
+        initResNorm = absResNorm;
+    else if (absResNorm < m_options.getReal("AbsTol") || absResNorm/initResNorm < m_options.getReal("RelTol"))
+        converged = true;
+
+    quasiNewtonStep(output,residual,numIter > 1,iqnInput);
+    setVector(iqnInput,disp);
+}
+
+template <class T>
+void gsPartitionedFSI<T>::quasiNewtonStep(const gsMatrix<T> & output, const gsMatrix<T> & residual,
+                                          bool newPair, gsMatrix<T> & nextInput)
+{
+    // new secant pair from the last two iterations
+    if (newPair)
+    {
+        gsMatrix<T> newV = residual - iqnResidual;
+        gsMatrix<T> newW = output - iqnOutput;
+        appendColumns(newV,iqnV);
+        appendColumns(newW,iqnW);
+        iqnV.swap(newV);
+        iqnW.swap(newW);
+    }
+    iqnResidual = residual;
+    iqnOutput = output;
+
+    // secant pairs of the current and, for IQN-ILS, previous time steps
+    gsMatrix<T> V = iqnV;
+    gsMatrix<T> W = iqnW;
+    if (m_options.getInt("Acceleration") == coupling_acceleration::IQN_ILS)
+        for (size_t s = 0; s < iqnHistory.size(); ++s)
+            if (iqnHistory[s].first.rows() == residual.rows()) // skip pairs of the other coupling scheme
+            {
+                appendColumns(V,iqnHistory[s].first);
+                appendColumns(W,iqnHistory[s].second);
+            }
+    filterColumns(V,W);
+
+    // next input = output - J*residual, where the inverse Jacobian J maps residual differences V
+    // onto output differences W; IQN-ILS: J = W*pinv(V), IQN-IMVJ: J = Jold + (W - Jold*V)*pinv(V)
+    gsMatrix<T> coefs;
+    if (V.cols() > 0)
+        coefs = V.householderQr().solve(residual);
+    gsMatrix<T> update = gsMatrix<T>::Zero(residual.rows(),1);
+    if (m_options.getInt("Acceleration") == coupling_acceleration::IQN_IMVJ)
+    {
+        if (iqnJacobian.rows() != residual.rows())
+            iqnJacobian.setZero(residual.rows(),residual.rows());
+        update = iqnJacobian*residual;
+        if (V.cols() > 0)
+        {
+            gsMatrix<T> temp = W - iqnJacobian*V;
+            update += temp*coefs;
+        }
+    }
+    else if (V.cols() > 0)
+        update = W*coefs;
+
+    nextInput = output - update;
+}
+
+template <class T>
+void gsPartitionedFSI<T>::filterColumns(gsMatrix<T> & V, gsMatrix<T> & W) const
+{
+    // no more pairs than interface DoFs
+    if (V.cols() > V.rows())
+    {
+        V.conservativeResize(V.rows(),V.rows());
+        W.conservativeResize(W.rows(),V.cols());
+    }
+
+    const T tol = m_options.getReal("IQNFilter");
+    bool filtered = true;
+    while (filtered && V.cols() > 0)
+    {
+        filtered = false;
+        gsMatrix<T> R = V.householderQr().matrixQR().topRows(V.cols()).template triangularView<Eigen::Upper>();
+        const T normR = R.norm();
+        for (index_t i = 0; i < R.cols() && !filtered; ++i)
+            if (math::abs(R(i,i)) < tol*normR)
+            {
+                // shift the older pairs to the left and drop the last column
+                const index_t numOlder = V.cols()-i-1;
+                if (numOlder > 0)
+                {
+                    V.middleCols(i,numOlder) = V.rightCols(numOlder).eval();
+                    W.middleCols(i,numOlder) = W.rightCols(numOlder).eval();
+                }
+                V.conservativeResize(V.rows(),V.cols()-1);
+                W.conservativeResize(W.rows(),W.cols()-1);
+                filtered = true;
+            }
+    }
+}
+
+template <class T>
+void gsPartitionedFSI<T>::finalizeQuasiNewton()
+{
+    if (m_options.getInt("Acceleration") == coupling_acceleration::IQN_IMVJ)
+    {
+        gsMatrix<T> V = iqnV;
+        gsMatrix<T> W = iqnW;
+        filterColumns(V,W);
+        if (V.cols() == 0)
+            return;
+        // J = Jold + (W - Jold*V)*pinv(V)
+        gsMatrix<T> pinvV = V.householderQr().solve(gsMatrix<T>::Identity(V.rows(),V.rows()));
+        gsMatrix<T> temp = W - iqnJacobian*V;
+        iqnJacobian += temp*pinvV;
+    }
+    else
+    {
+        if (iqnV.cols() > 0)
+            iqnHistory.push_front(std::make_pair(iqnV,iqnW));
+        while (iqnHistory.size() > (size_t)m_options.getInt("IQNReuse"))
+            iqnHistory.pop_back();
+    }
+}
+
+template <class T>
+void gsPartitionedFSI<T>::appendColumns(gsMatrix<T> & A, const gsMatrix<T> & B)
+{
+    if (B.cols() == 0)
+        return;
+    if (A.cols() == 0)
+    {
+        A = B;
+        return;
+    }
+    const index_t cols = A.cols();
+    A.conservativeResize(A.rows(),cols+B.cols());
+    A.rightCols(B.cols()) = B;
+}
+
 } // namespace ends
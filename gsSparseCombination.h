@@ -0,0 +1,99 @@
+/** @file gsSparseCombination.h
+
+    @brief Computes linear combinations of two sparse matrices in place
+    using a precomputed union sparsity pattern.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+
+namespace gismo
+{
+
+/// hash of the sparsity pattern of a compressed sparse matrix, i.e. of its outer and inner index arrays
+template <class T>
+size_t sparsePatternHash(const gsSparseMatrix<T> & matrix)
+{
+    size_t hash = 0;
+    const index_t * outer = matrix.outerIndexPtr();
+    const index_t * inner = matrix.innerIndexPtr();
+    for (index_t i = 0; i <= matrix.outerSize(); ++i)
+        hash ^= size_t(outer[i]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    for (index_t i = 0; i < matrix.nonZeros(); ++i)
+        hash ^= size_t(inner[i]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+/** @brief Forms C = a*A + b*B for compressed column-major sparse matrices, where B can be smaller than A
+ * and is added to the top-left block of A (for example, a mass matrix to the velocity block of a saddle point system).
+ * Entries of A inside this block can be scaled with a different factor aBlock.
+ *
+ * At the first call, the union pattern of A and B is computed together with maps from the nonzeros of A and B
+ * to the nonzeros of C. As long as the sparsity patterns of A, B and C stay the same, subsequent calls only overwrite
+ * the values of C without any memory allocation. The pattern of C is also preserved, so that a symbolic factorization
+ * of C can be reused, see gsLinearSolverCache.
+ *
+ * A pattern is considered the same if the size and the number of nonzeros are the same and the index arrays
+ * have not been reallocated since the last call. Only if they have been reallocated, e.g. by a new assembly,
+ * their hash is compared, see sparsePatternHash. Call reset() if a pattern changes in place
+ * without changing the number of nonzeros.
+*/
+template <class T>
+class gsSparseCombination
+{
+public:
+    gsSparseCombination() { reset(); }
+
+    /// C = a*A + b*B
+    void compute(const gsSparseMatrix<T> & A, T a,
+                 const gsSparseMatrix<T> & B, T b,
+                 gsSparseMatrix<T> & C)
+    { compute(A,a,a,B,b,C); }
+
+    /// C = a*A + b*B, entries of A in the top-left block of size B are scaled with aBlock instead of a
+    void compute(const gsSparseMatrix<T> & A, T a, T aBlock,
+                 const gsSparseMatrix<T> & B, T b,
+                 gsSparseMatrix<T> & C);
+
+    /// forget the stored pattern
+    void reset()
+    {
+        m_rowsA = m_colsA = m_nnzA = m_rowsB = m_colsB = m_nnzB = m_nnzC = -1;
+        m_hashA = m_hashB = m_hashC = 0;
+        m_outerA = m_innerA = m_outerB = m_innerB = m_outerC = m_innerC = nullptr;
+    }
+
+protected:
+    /// computes the union pattern of A and B, stores it in C and computes the index maps
+    void computePattern(const gsSparseMatrix<T> & A, const gsSparseMatrix<T> & B, gsSparseMatrix<T> & C);
+
+    /// true if the index arrays of the matrix are the stored ones or, after a reallocation, have the stored hash;
+    /// in the latter case, the stored addresses are updated
+    bool samePattern(const gsSparseMatrix<T> & matrix, size_t hash, const index_t * & outer, const index_t * & inner);
+
+protected:
+    /// stored pattern info
+    index_t m_rowsA, m_colsA, m_nnzA, m_rowsB, m_colsB, m_nnzB, m_nnzC;
+    size_t m_hashA, m_hashB, m_hashC;
+    const index_t * m_outerA, * m_innerA, * m_outerB, * m_innerB, * m_outerC, * m_innerC;
+    /// positions of the nonzeros of A and B in the value array of C
+    gsVector<index_t> mapA, mapB;
+    /// for every nonzero of A: true if it lies in the top-left block covered by B
+    std::vector<bool> inBlockA;
+};
+
+} // namespace ends
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsSparseCombination.hpp)
+#endif
@@ -0,0 +1,148 @@
+/** @file gsSparseCombination.hpp
+
+    @brief Computes linear combinations of two sparse matrices in place
+    using a precomputed union sparsity pattern.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsElasticity/gsSparseCombination.h>
+
+namespace gismo
+{
+
+template <class T>
+void gsSparseCombination<T>::compute(const gsSparseMatrix<T> & A, T a, T aBlock,
+                                     const gsSparseMatrix<T> & B, T b,
+                                     gsSparseMatrix<T> & C)
+{
+    GISMO_ENSURE(A.isCompressed() && B.isCompressed(),"The matrices must be compressed!");
+    GISMO_ENSURE(B.rows() <= A.rows() && B.cols() <= A.cols(),"B must fit into A!");
+
+    // the index maps are only valid for the same patterns; hashes are only computed for reallocated index arrays
+    if (A.rows() != m_rowsA || A.cols() != m_colsA || A.nonZeros() != m_nnzA ||
+        B.rows() != m_rowsB || B.cols() != m_colsB || B.nonZeros() != m_nnzB ||
+        C.rows() != A.rows() || C.cols() != A.cols() || C.nonZeros() != m_nnzC || !C.isCompressed() ||
+        !samePattern(A,m_hashA,m_outerA,m_innerA) || !samePattern(B,m_hashB,m_outerB,m_innerB) ||
+        !samePattern(C,m_hashC,m_outerC,m_innerC))
+        computePattern(A,B,C);
+
+    T * valC = C.valuePtr();
+    const T * valA = A.valuePtr();
+    const T * valB = B.valuePtr();
+    std::fill(valC,valC+m_nnzC,T(0));
+    for (index_t k = 0; k < m_nnzA; ++k)
+        valC[mapA[k]] += (inBlockA[k] ? aBlock : a) * valA[k];
+    for (index_t k = 0; k < m_nnzB; ++k)
+        valC[mapB[k]] += b * valB[k];
+}
+
+template <class T>
+void gsSparseCombination<T>::computePattern(const gsSparseMatrix<T> & A, const gsSparseMatrix<T> & B,
+                                            gsSparseMatrix<T> & C)
+{
+    const index_t * outerA = A.outerIndexPtr();
+    const index_t * innerA = A.innerIndexPtr();
+    const index_t * outerB = B.outerIndexPtr();
+    const index_t * innerB = B.innerIndexPtr();
+
+    // first pass: count the nonzeros of the union pattern column by column
+    index_t nnz = 0;
+    for (index_t j = 0; j < A.cols(); ++j)
+    {
+        index_t kA = outerA[j], kB = j < B.cols() ? outerB[j] : 0;
+        const index_t endA = outerA[j+1], endB = j < B.cols() ? outerB[j+1] : 0;
+        while (kA < endA || kB < endB)
+        {
+            if (kB >= endB || (kA < endA && innerA[kA] < innerB[kB]))
+                ++kA;
+            else if (kA >= endA || innerB[kB] < innerA[kA])
+                ++kB;
+            else
+            { ++kA; ++kB; }
+            ++nnz;
+        }
+    }
+
+    // second pass: fill the pattern of C and the maps
+    C.resize(A.rows(),A.cols());
+    C.resizeNonZeros(nnz);
+    index_t * outerC = C.outerIndexPtr();
+    index_t * innerC = C.innerIndexPtr();
+    mapA.resize(A.nonZeros());
+    mapB.resize(B.nonZeros());
+    inBlockA.assign(A.nonZeros(),false);
+    index_t kC = 0;
+    outerC[0] = 0;
+    for (index_t j = 0; j < A.cols(); ++j)
+    {
+        index_t kA = outerA[j], kB = j < B.cols() ? outerB[j] : 0;
+        const index_t endA = outerA[j+1], endB = j < B.cols() ? outerB[j+1] : 0;
+        while (kA < endA || kB < endB)
+        {
+            if (kB >= endB || (kA < endA && innerA[kA] < innerB[kB]))
+            {
+                innerC[kC] = innerA[kA];
+                mapA[kA++] = kC;
+            }
+            else if (kA >= endA || innerB[kB] < innerA[kA])
+            {
+                innerC[kC] = innerB[kB];
+                mapB[kB++] = kC;
+            }
+            else
+            {
+                innerC[kC] = innerA[kA];
+                mapA[kA++] = kC;
+                mapB[kB++] = kC;
+            }
+            ++kC;
+        }
+        outerC[j+1] = kC;
+    }
+    // entries of A in the top-left block
+    for (index_t j = 0; j < B.cols(); ++j)
+        for (index_t k = outerA[j]; k < outerA[j+1]; ++k)
+            inBlockA[k] = innerA[k] < B.rows();
+
+    m_rowsA = A.rows();
+    m_colsA = A.cols();
+    m_nnzA = A.nonZeros();
+    m_rowsB = B.rows();
+    m_colsB = B.cols();
+    m_nnzB = B.nonZeros();
+    m_nnzC = nnz;
+    m_hashA = sparsePatternHash(A);
+    m_hashB = sparsePatternHash(B);
+    m_hashC = sparsePatternHash(C);
+    m_outerA = A.outerIndexPtr();
+    m_innerA = A.innerIndexPtr();
+    m_outerB = B.outerIndexPtr();
+    m_innerB = B.innerIndexPtr();
+    m_outerC = C.outerIndexPtr();
+    m_innerC = C.innerIndexPtr();
+}
+
+template <class T>
+bool gsSparseCombination<T>::samePattern(const gsSparseMatrix<T> & matrix, size_t hash,
+                                         const index_t * & outer, const index_t * & inner)
+{
+    if (matrix.outerIndexPtr() == outer && matrix.innerIndexPtr() == inner)
+        return true;
+    if (sparsePatternHash(matrix) != hash)
+        return false;
+    outer = matrix.outerIndexPtr();
+    inner = matrix.innerIndexPtr();
+    return true;
+}
+
+} // namespace ends
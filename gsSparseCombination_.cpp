@@ -0,0 +1,9 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsElasticity/gsSparseCombination.h>
+#include <gsElasticity/gsSparseCombination.hpp>
+
+namespace gismo
+{
+    CLASS_TEMPLATE_INST gsSparseCombination<real_t>;
+}
@@ -43,6 +43,9 @@ public:
     /// @brief Assembles the thermal expanstion contribution to the RHS
     void assembleThermo();
 
+    /// @brief Eliminates new Dirichlet degrees of freedom; requires assemble(true). The thermal contribution is kept
+    virtual void eliminateFixedDofs();
+
 protected:
     /// @brief Marks all non-Dirichlet sides for assembly of the boundary thermal stresses
     void findNonDirichletSides();
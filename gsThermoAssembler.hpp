@@ -43,13 +43,23 @@ gsThermoAssembler<T>::gsThermoAssembler(const gsMultiPatch<T> & patches,
 template <class T>
 void gsThermoAssembler<T>::assemble(bool saveEliminationMatrix)
 {
-    gsElasticityAssembler<T>::assemble();
+    gsElasticityAssembler<T>::assemble(saveEliminationMatrix);
     elastRhs = gsAssembler<T>::m_system.rhs();
     assembledElasticity = true;
 
     assembleThermo();
 }
 
+template <class T>
+void gsThermoAssembler<T>::eliminateFixedDofs()
+{
+    // the thermal contribution does not depend on the Dirichlet DoFs
+    gsMatrix<T> thermoRhs = gsAssembler<T>::m_system.rhs() - elastRhs;
+    Base::eliminateFixedDofs();
+    elastRhs = gsAssembler<T>::m_system.rhs();
+    gsAssembler<T>::m_system.rhs() += thermoRhs;
+}
+
 template <class T>
 void gsThermoAssembler<T>::findNonDirichletSides()
 {
@@ -74,7 +84,7 @@ void gsThermoAssembler<T>::assembleThermo()
     gsAssembler<T>::m_system.rhs().setZero();
 
     gsVisitorThermo<T> visitor(m_temperatureField);
-    gsAssembler<T>::template push<gsVisitorThermo<T> >(visitor);
+    Base::template push<gsVisitorThermo<T> >(visitor);
 
     for (auto const & it : nonDirichletSides)
     {
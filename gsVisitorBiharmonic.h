@@ -16,6 +16,7 @@
 
 #include <gsAssembler/gsQuadrature.h>
 #include <gsCore/gsFuncData.h>
+#include <gsElasticity/gsVisitorElUtils.h>
 
 namespace gismo
 {
@@ -25,9 +26,9 @@ class gsVisitorBiharmonic
 {
 public:
 
-    gsVisitorBiharmonic(const gsPde<T> & pde_, gsSparseMatrix<T> * elimMatrix = nullptr)
+    gsVisitorBiharmonic(const gsPde<T> & pde_, gsSparseEntries<T> * elimEntries_ = nullptr)
         : pde_ptr(static_cast<const gsPoissonPde<T>*>(&pde_)),
-          elimMat(elimMatrix)
+          elimEntries(elimEntries_)
     {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
@@ -111,26 +112,13 @@ public:
         system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
 
         // push to the elimination system
-        if (elimMat != nullptr)
+        if (elimEntries != nullptr)
         {
-            index_t globalI,globalElimJ;
-            index_t elimSize = 0;
-            for (short_t dJ = 0; dJ < 2; ++dJ)
-            {
-                for (short_t dI = 0; dI < 2; ++dI)
-                    for (index_t i = 0; i < N_M; ++i)
-                        if (system.colMapper(dI).is_free_index(globalIndices[dI].at(i)))
-                        {
-                            system.mapToGlobalRowIndex(localIndicesMain.at(i),patchIndex,globalI,dI);
-                            for (index_t j = 0; j < N_M; ++j)
-                                if (!system.colMapper(dJ).is_free_index(globalIndices[dJ].at(j)))
-                                {
-                                    globalElimJ = system.colMapper(dJ).global_to_bindex(globalIndices[dJ].at(j));
-                                    elimMat->coeffRef(globalI,elimSize+globalElimJ) += localMat(N_M*dI+i,N_M*dJ+j);
-                                }
-                        }
-                elimSize += eliminatedDofs[dJ].rows();
-            }
+            localIndices.resize(2);
+            localIndices[0] = localIndicesMain;
+            localIndices[1] = localIndicesAux;
+            pushToEliminationEntries(localMat,localIndices,globalIndices,blockNumbers,eliminatedDofs,
+                                     system,patchIndex,*elimEntries);
         }
     }
 
@@ -157,9 +145,10 @@ protected:
     // all temporary matrices defined here for efficiency
     gsMatrix<T> block, physGradMain, physGradAux;
     real_t localStiffening;
-    // elimination matrix to efficiently change Dirichlet degrees of freedom
-    gsSparseMatrix<T> * elimMat;
-    // containers for global indices
+    // entries of the elimination matrix to efficiently change Dirichlet degrees of freedom
+    gsSparseEntries<T> * elimEntries;
+    // containers for local (per block) and global indices
+    std::vector< gsMatrix<index_t> > localIndices;
     std::vector< gsMatrix<index_t> > globalIndices;
     gsVector<index_t> blockNumbers;
 };
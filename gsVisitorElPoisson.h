@@ -16,6 +16,7 @@
 
 #include <gsAssembler/gsQuadrature.h>
 #include <gsCore/gsFuncData.h>
+#include <gsElasticity/gsVisitorElUtils.h>
 
 namespace gismo
 {
@@ -25,9 +26,9 @@ class gsVisitorElPoisson
 {
 public:
 
-    gsVisitorElPoisson(const gsPde<T> & pde_, gsSparseMatrix<T> * elimMatrix = nullptr)
+    gsVisitorElPoisson(const gsPde<T> & pde_, gsSparseEntries<T> * elimEntries_ = nullptr)
         : pde_ptr(static_cast<const gsPoissonPde<T>*>(&pde_)),
-          elimMat(elimMatrix)
+          elimEntries(elimEntries_)
     {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
@@ -91,20 +92,11 @@ public:
         system.pushToRhs(localRhs,globalIndices,blockNumbers);
 
         // push to the elimination matrix
-        if (elimMat != nullptr)
+        if (elimEntries != nullptr)
         {
-            index_t globalI, globalElimJ;
-            for (index_t i = 0; i < N; ++i)
-                if (system.colMapper(0).is_free_index(globalIndices[0].at(i)))
-                {
-                    system.mapToGlobalRowIndex(localIndices.at(i),patchIndex,globalI,0);
-                    for (index_t j = 0; j < N; ++j)
-                        if (!system.colMapper(0).is_free_index(globalIndices[0].at(j)))
-                        {
-                            globalElimJ = system.colMapper(0).global_to_bindex(globalIndices[0].at(j));
-                            elimMat->coeffRef(globalI,globalElimJ) += localMat(i,j);
-                        }
-                }
+            localIndicesBlocks.assign(1,localIndices);
+            pushToEliminationEntries(localMat,localIndicesBlocks,globalIndices,blockNumbers,eliminatedDofs,
+                                     system,patchIndex,*elimEntries);
         }
     }
 
@@ -123,8 +115,10 @@ protected:
     std::vector<gsMatrix<T> >basisValues;
     // RHS values at quadrature points at the current element; stored as a dim x numQuadPoints matrix
     gsMatrix<T> forceValues;
-    // elimination matrix to efficiently change Dirichlet degrees of freedom
-    gsSparseMatrix<T> * elimMat;
+    // entries of the elimination matrix to efficiently change Dirichlet degrees of freedom
+    gsSparseEntries<T> * elimEntries;
+    // local indices of the only block, see pushToEliminationEntries
+    std::vector< gsMatrix<index_t> > localIndicesBlocks;
 
     // all temporary matrices defined here for efficiency
     gsMatrix<T> physGrad;
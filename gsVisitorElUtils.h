@@ -54,6 +54,16 @@ inline void symmetricIdentityTensor(gsMatrix<T> & C, const gsMatrix<T> & R)
                         R(voigt(dim,i,0),voigt(dim,j,1))*R(voigt(dim,i,1),voigt(dim,j,0)));
 }
 
+// fixed-size version of symmetricIdentityTensor for a compile-time dimension d
+template <class T, int d>
+inline void symmetricIdentityTensor(gsMatrix<T,d*(d+1)/2,d*(d+1)/2> & C, const gsMatrix<T,d,d> & R)
+{
+    for (short_t i = 0; i < d*(d+1)/2; ++i)
+        for (short_t j = 0; j < d*(d+1)/2; ++j)
+            C(i,j) = (R(voigt(d,i,0),voigt(d,j,0))*R(voigt(d,i,1),voigt(d,j,1)) +
+                        R(voigt(d,i,0),voigt(d,j,1))*R(voigt(d,i,1),voigt(d,j,0)));
+}
+
 // construct a fourth order matrix-trace tensor C based on two second order symmetric tensors R and S
 // C_ijkl = R_ij*S_kl in Voigt notation
 template <class T>
@@ -68,6 +78,15 @@ inline void matrixTraceTensor(gsMatrix<T> & C, const gsMatrix<T> & R, const gsMa
             C(i,j) = R(voigt(dim,i,0),voigt(dim,i,1))*S(voigt(dim,j,0),voigt(dim,j,1));
 }
 
+// fixed-size version of matrixTraceTensor for a compile-time dimension d
+template <class T, int d>
+inline void matrixTraceTensor(gsMatrix<T,d*(d+1)/2,d*(d+1)/2> & C, const gsMatrix<T,d,d> & R, const gsMatrix<T,d,d> & S)
+{
+    for (short_t i = 0; i < d*(d+1)/2; ++i)
+        for (short_t j = 0; j < d*(d+1)/2; ++j)
+            C(i,j) = R(voigt(d,i,0),voigt(d,i,1))*S(voigt(d,j,0),voigt(d,j,1));
+}
+
 // transform stress tensor S to a vector in Voigt notation
 template <class T>
 inline void voigtStress(gsVector<T> & Svec, const gsMatrix<T> & S)
@@ -79,6 +98,34 @@ inline void voigtStress(gsVector<T> & Svec, const gsMatrix<T> & S)
         Svec(i) = S(voigt(dim,i,0),voigt(dim,i,1));
 }
 
+// fixed-size version of voigtStress for a compile-time dimension d
+template <class T, int d>
+inline void voigtStress(gsVector<T,d*(d+1)/2> & Svec, const gsMatrix<T,d,d> & S)
+{
+    for (short i = 0; i < d*(d+1)/2; ++i)
+        Svec(i) = S(voigt(d,i,0),voigt(d,i,1));
+}
+
+// transform the symmetric part of a displacement gradient H to a strain vector in Voigt notation
+// with doubled shear components, i.e. Evec = B*u for H = grad(u)
+template <class T, int d>
+inline void voigtStrain(gsVector<T,d*(d+1)/2> & Evec, const gsMatrix<T,d,d> & H)
+{
+    for (short i = 0; i < d*(d+1)/2; ++i)
+        Evec(i) = i < d ? H(i,i) : H(voigt(d,i,0),voigt(d,i,1)) + H(voigt(d,i,1),voigt(d,i,0));
+}
+
+// transform a stress vector in Voigt notation to a symmetric stress tensor S, inverse of voigtStress
+template <class T, int d>
+inline void voigtToTensor(gsMatrix<T,d,d> & S, const gsVector<T,d*(d+1)/2> & Svec)
+{
+    for (short i = 0; i < d*(d+1)/2; ++i)
+    {
+        S(voigt(d,i,0),voigt(d,i,1)) = Svec(i);
+        S(voigt(d,i,1),voigt(d,i,0)) = Svec(i);
+    }
+}
+
 // auxiliary matrix B such that E:S = B*Svec in the weak form
 // (see Bernal, Calo, Collier, et. at., "PetIGA", ICCS 2013, p. 1610)
 template <class T>
@@ -103,4 +150,74 @@ inline void setB( gsMatrix<T> & B, const gsMatrix<T> & F, const gsVector<T> & bG
     }
 }
 
+// B-matrices of all N active basis functions at once (see setB) for a given dimension d;
+// the column a*N+i holds the a-th column of B_i. The dimTensor x d*N result is written to B starting at the row *row*,
+// so that matrices of several quadrature points can be stacked and multiplied at once
+template <class T, int d>
+inline void setBAll(gsMatrix<T> & B, index_t row, const gsMatrix<T,d,d> & F, const gsMatrix<T> & grads)
+{
+    const index_t N = grads.cols();
+    for (short_t a = 0; a < d; ++a)
+    {
+        for (short_t i = 0; i < d; ++i)
+            B.block(row+i,a*N,1,N).noalias() = F(a,i) * grads.row(i);
+        if (d == 2)
+            B.block(row+2,a*N,1,N).noalias() = F(a,0) * grads.row(1) + F(a,1) * grads.row(0);
+        if (d == 3)
+            for (short_t i = 0; i < d; ++i)
+            {
+                short_t k = (i+1)%d;
+                B.block(row+i+d,a*N,1,N).noalias() = F(a,i) * grads.row(k) + F(a,k) * grads.row(i);
+            }
+    }
+}
+
+/** @brief Collects the entries of a local matrix which couple free DoFs (rows) with eliminated Dirichlet DoFs (columns)
+ * as triplets of the elimination matrix. The local matrix consists of blocks corresponding to *blockNumbers*;
+ * *localIndices* and *globalIndices* hold patch-local and mapped (see gsSparseSystem::mapColIndices) indices of each block.
+ * The columns of the elimination matrix contain eliminated DoFs of all unknowns one after another.
+ * Duplicates are summed up when the matrix is formed, see gsBaseAssembler::setEliminationMatrix.
+*/
+template <class T>
+void pushToEliminationEntries(const gsMatrix<T> & localMat,
+                              const std::vector<gsMatrix<index_t> > & localIndices,
+                              const std::vector<gsMatrix<index_t> > & globalIndices,
+                              const gsVector<index_t> & blockNumbers,
+                              const std::vector<gsMatrix<T> > & eliminatedDofs,
+                              const gsSparseSystem<T> & system,
+                              index_t patchIndex,
+                              gsSparseEntries<T> & entries)
+{
+    const index_t numBlocks = blockNumbers.rows();
+    // offsets of the blocks in the local matrix
+    gsVector<index_t> localOffsets(numBlocks+1);
+    localOffsets(0) = 0;
+    for (index_t b = 0; b < numBlocks; ++b)
+        localOffsets(b+1) = localOffsets(b) + localIndices[b].rows();
+    // offsets of the eliminated DoFs of each unknown in the columns of the elimination matrix
+    gsVector<index_t> elimOffsets(eliminatedDofs.size()+1);
+    elimOffsets(0) = 0;
+    for (size_t d = 0; d < eliminatedDofs.size(); ++d)
+        elimOffsets(d+1) = elimOffsets(d) + eliminatedDofs[d].rows();
+
+    index_t globalI;
+    for (index_t bI = 0; bI < numBlocks; ++bI)
+    {
+        const gsDofMapper & mapperI = system.colMapper(blockNumbers(bI));
+        for (index_t i = 0; i < localIndices[bI].rows(); ++i)
+            if (mapperI.is_free_index(globalIndices[bI].at(i)))
+            {
+                system.mapToGlobalRowIndex(localIndices[bI].at(i),patchIndex,globalI,blockNumbers(bI));
+                for (index_t bJ = 0; bJ < numBlocks; ++bJ)
+                {
+                    const gsDofMapper & mapperJ = system.colMapper(blockNumbers(bJ));
+                    for (index_t j = 0; j < localIndices[bJ].rows(); ++j)
+                        if (!mapperJ.is_free_index(globalIndices[bJ].at(j)))
+                            entries.add(globalI,elimOffsets(blockNumbers(bJ)) + mapperJ.global_to_bindex(globalIndices[bJ].at(j)),
+                                        localMat(localOffsets(bI)+i,localOffsets(bJ)+j));
+                }
+            }
+    }
+}
+
 } // namespace gismo
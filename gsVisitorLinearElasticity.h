@@ -29,9 +29,9 @@ class gsVisitorLinearElasticity
 {
 public:
 
-    gsVisitorLinearElasticity(const gsPde<T> & pde_, gsSparseMatrix<T> * elimMatrix = nullptr)
+    gsVisitorLinearElasticity(const gsPde<T> & pde_, gsSparseEntries<T> * elimEntries_ = nullptr)
         : pde_ptr(static_cast<const gsBasePde<T>*>(&pde_)),
-          elimMat(elimMatrix)
+          elimEntries(elimEntries_)
     {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
@@ -85,37 +85,10 @@ public:
     inline void assemble(gsDomainIterator<T> & element,
                          const gsVector<T> & quWeights)
     {
-        // initialize local matrix and rhs
-        localMat.setZero(dim*N_D,dim*N_D);
-        localRhs.setZero(dim*N_D,1);
-        // Loop over the quadrature nodes
-        for (index_t q = 0; q < quWeights.rows(); ++q)
-        {
-            // Multiply quadrature weight by the geometry measure
-            const T weightForce = quWeights[q] * md.measure(q);
-            const T weightBody = quWeights[q] * pow(md.measure(q),1-localStiffening);
-            // Compute physical gradients of basis functions at q as a dim x numActiveFunction matrix
-            transformGradients(md,q,basisValuesDisp[1],physGrad);
-            // loop over active basis functions (v_j)
-            for (index_t i = 0; i < N_D; i++)
-            {
-                // stiffness matrix K = B_i^T * C * B_j;
-                setB<T>(B_i,I,physGrad.col(i));
-                tempK = B_i.transpose() * C;
-                // loop over active basis functions (v_j)
-                for (index_t j = 0; j < N_D; j++)
-                {
-                    setB<T>(B_j,I,physGrad.col(j));
-                    K = tempK * B_j;
-                    for (short_t di = 0; di < dim; ++di)
-                        for (short_t dj = 0; dj < dim; ++dj)
-                            localMat(di*N_D+i,dj*N_D+j) += weightBody * K(di,dj);
-                }
-            }
-            // rhs contribution
-            for (short_t d = 0; d < dim; ++d)
-                localRhs.middleRows(d*N_D,N_D).noalias() += weightForce * forceScaling * forceValues(d,q) * basisValuesDisp[0].col(q) ;
-        }
+        if (dim == 2)
+            assembleElement<2>(quWeights);
+        else
+            assembleElement<3>(quWeights);
     }
 
     inline void localToGlobal(const int patchIndex,
@@ -132,30 +105,47 @@ public:
         system.pushToRhs(localRhs,globalIndices,blockNumbers);
         system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
         // push to the elimination system
-        if (elimMat != nullptr)
+        if (elimEntries != nullptr)
         {
-            index_t globalI,globalElimJ;
-            index_t elimSize = 0;
-            for (short_t dJ = 0; dJ < dim; ++dJ)
-            {
-                for (short_t dI = 0; dI < dim; ++dI)
-                    for (index_t i = 0; i < N_D; ++i)
-                        if (system.colMapper(dI).is_free_index(globalIndices[dI].at(i)))
-                        {
-                            system.mapToGlobalRowIndex(localIndicesDisp.at(i),patchIndex,globalI,dI);
-                            for (index_t j = 0; j < N_D; ++j)
-                                if (!system.colMapper(dJ).is_free_index(globalIndices[dJ].at(j)))
-                                {
-                                    globalElimJ = system.colMapper(dJ).global_to_bindex(globalIndices[dJ].at(j));
-                                    elimMat->coeffRef(globalI,elimSize+globalElimJ) += localMat(N_D*dI+i,N_D*dJ+j);
-                                }
-                        }
-                elimSize += eliminatedDofs[dJ].rows();
-            }
+            localIndices.assign(dim,localIndicesDisp);
+            pushToEliminationEntries(localMat,localIndices,globalIndices,blockNumbers,eliminatedDofs,
+                                     system,patchIndex,*elimEntries);
         }
     }
 
 protected:
+    // element stiffness matrix as a single dense product over all quadrature points: K = sum_q w_q * B_q^T * C * B_q,
+    // where B_q contains B-matrices of all active basis functions at the quadrature point q (see setBAll)
+    template <short_t d>
+    void assembleElement(const gsVector<T> & quWeights)
+    {
+        const short_t dimTensor = d*(d+1)/2;
+        const index_t N_Q = quWeights.rows();
+        const gsMatrix<T,d*(d+1)/2,d*(d+1)/2> Cfixed = C;
+        const gsMatrix<T,d,d> Ifixed = gsMatrix<T,d,d>::Identity();
+        // initialize stacked B-matrices and rhs
+        Bstack.resize(N_Q*dimTensor,d*N_D);
+        CBstack.resize(N_Q*dimTensor,d*N_D);
+        localRhs.setZero(d*N_D,1);
+        // Loop over the quadrature nodes
+        for (index_t q = 0; q < N_Q; ++q)
+        {
+            // Multiply quadrature weight by the geometry measure
+            const T weightForce = quWeights[q] * md.measure(q);
+            const T weightBody = quWeights[q] * pow(md.measure(q),1-localStiffening);
+            // Compute physical gradients of basis functions at q as a dim x numActiveFunction matrix
+            transformGradients(md,q,basisValuesDisp[1],physGrad);
+            // B-matrices of all active basis functions and their product with the weighted elasticity tensor
+            setBAll<T>(Bstack,q*dimTensor,Ifixed,physGrad);
+            CBstack.middleRows(q*dimTensor,dimTensor).noalias() = weightBody * Cfixed * Bstack.middleRows(q*dimTensor,dimTensor);
+            // rhs contribution
+            for (short_t k = 0; k < d; ++k)
+                localRhs.middleRows(k*N_D,N_D).noalias() += weightForce * forceScaling * forceValues(k,q) * basisValuesDisp[0].col(q) ;
+        }
+        // stiffness matrix K = B^T * C * B
+        localMat.noalias() = Bstack.transpose() * CBstack;
+    }
+
     // problem info
     short_t dim;
     const gsBasePde<T> * pde_ptr;
@@ -175,11 +165,12 @@ protected:
     std::vector<gsMatrix<T> > basisValuesDisp;
     // RHS values at quadrature points at the current element; stored as a dim x numQuadPoints matrix
     gsMatrix<T> forceValues;
-    // elimination matrix to efficiently change Dirichlet degrees of freedom
-    gsSparseMatrix<T> * elimMat;
+    // entries of the elimination matrix to efficiently change Dirichlet degrees of freedom
+    gsSparseEntries<T> * elimEntries;
     // all temporary matrices defined here for efficiency
-    gsMatrix<T> C, Ctemp,physGrad, B_i, tempK, B_j, K, I;
-    // containers for global indices
+    gsMatrix<T> C, Ctemp, physGrad, I, Bstack, CBstack;
+    // containers for local (per block) and global indices
+    std::vector< gsMatrix<index_t> > localIndices;
     std::vector< gsMatrix<index_t> > globalIndices;
     gsVector<index_t> blockNumbers;
 };
@@ -17,6 +17,7 @@
 
 #include <gsAssembler/gsQuadrature.h>
 #include <gsCore/gsFuncData.h>
+#include <gsElasticity/gsVisitorElUtils.h>
 
 namespace gismo
 {
@@ -26,8 +27,13 @@ class gsVisitorMass
 {
 public:
 
-    gsVisitorMass(gsSparseMatrix<T> * elimMatrix = nullptr) :
-    elimMat(elimMatrix) {}
+    gsVisitorMass(gsSparseEntries<T> * elimEntries_ = nullptr) :
+    elimEntries(elimEntries_), lumped(false), hrz(false) {}
+
+    /// constructor for the lumped mass vector which is assembled into the rhs: row-sum lumping
+    /// or, if *hrz_* is true, the HRZ lumping (diagonal of the element mass matrix scaled to the element mass)
+    gsVisitorMass(bool hrz_) :
+    elimEntries(nullptr), lumped(true), hrz(hrz_) {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
                     const index_t patchIndex,
@@ -66,9 +72,20 @@ public:
     inline void assemble(gsDomainIterator<T> & element,
                          const gsVector<T> & quWeights)
     {
+        block = density*basisValuesDisp * quWeights.asDiagonal() * md.measures.asDiagonal() * basisValuesDisp.transpose();
+        if (lumped)
+        {   // row sums are the integrals of density*N_i over the element; HRZ keeps the element mass as well
+            if (hrz)
+                lumpedBlock = block.diagonal() * (block.sum() / block.diagonal().sum());
+            else
+                lumpedBlock = block.rowwise().sum();
+            localRhs.resize(dim*N_D,1);
+            for (short_t d = 0; d < dim; ++d)
+                localRhs.middleRows(d*N_D,N_D) = lumpedBlock;
+            return;
+        }
         // initialize local matrix and rhs
         localMat.setZero(dim*N_D,dim*N_D);
-        block = density*basisValuesDisp * quWeights.asDiagonal() * md.measures.asDiagonal() * basisValuesDisp.transpose();
         for (short_t d = 0; d < dim; ++d)
             localMat.block(d*N_D,d*N_D,N_D,N_D) = block.block(0,0,N_D,N_D);
     }
@@ -83,30 +100,21 @@ public:
             system.mapColIndices(localIndicesDisp, patchIndex, globalIndices[d], d);
             blockNumbers.at(d) = d;
         }
+        // the lumped mass of the free DoFs includes their coupling to the fixed DoFs
+        if (lumped)
+        {
+            system.pushToRhs(localRhs,globalIndices,blockNumbers);
+            return;
+        }
         // push to global system
         system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
 
         // push to the elimination system
-        if (elimMat != nullptr)
+        if (elimEntries != nullptr)
         {
-            index_t globalI,globalElimJ;
-            index_t elimSize = 0;
-            for (short_t dJ = 0; dJ < dim; ++dJ)
-            {
-                for (short_t dI = 0; dI < dim; ++dI)
-                    for (index_t i = 0; i < N_D; ++i)
-                        if (system.colMapper(dI).is_free_index(globalIndices[dI].at(i)))
-                        {
-                            system.mapToGlobalRowIndex(localIndicesDisp.at(i),patchIndex,globalI,dI);
-                            for (index_t j = 0; j < N_D; ++j)
-                                if (!system.colMapper(dJ).is_free_index(globalIndices[dJ].at(j)))
-                                {
-                                    globalElimJ = system.colMapper(dJ).global_to_bindex(globalIndices[dJ].at(j));
-                                    elimMat->coeffRef(globalI,elimSize+globalElimJ) += localMat(N_D*dI+i,N_D*dJ+j);
-                                }
-                        }
-                elimSize += eliminatedDofs[dJ].rows();
-            }
+            localIndices.assign(dim,localIndicesDisp);
+            pushToEliminationEntries(localMat,localIndices,globalIndices,blockNumbers,eliminatedDofs,
+                                     system,patchIndex,*elimEntries);
         }
     }
 
@@ -126,12 +134,15 @@ protected:
     // values of displacement basis functions at quadrature points at the current element stored as a N_D x numQuadPoints matrix;
     gsMatrix<T> basisValuesDisp;
     bool assembleMatrix;
-    // elimination matrix to efficiently change Dirichlet degrees of freedom
-    gsSparseMatrix<T> * elimMat;
+    // entries of the elimination matrix to efficiently change Dirichlet degrees of freedom
+    gsSparseEntries<T> * elimEntries;
+    // assemble the lumped mass vector instead of the mass matrix
+    bool lumped, hrz;
 
     // all temporary matrices defined here for efficiency
-    gsMatrix<T> block;
-    // containers for global indices
+    gsMatrix<T> block, localRhs, lumpedBlock;
+    // containers for local (per block) and global indices
+    std::vector< gsMatrix<index_t> > localIndices;
     std::vector< gsMatrix<index_t> > globalIndices;
     gsVector<index_t> blockNumbers;
 };
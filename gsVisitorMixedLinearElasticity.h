@@ -28,8 +28,9 @@ template <class T>
 class gsVisitorMixedLinearElasticity
 {
 public:
-    gsVisitorMixedLinearElasticity(const gsPde<T> & pde_)
-        : pde_ptr(static_cast<const gsBasePde<T>*>(&pde_)) {}
+    gsVisitorMixedLinearElasticity(const gsPde<T> & pde_, gsSparseEntries<T> * elimEntries_ = nullptr)
+        : pde_ptr(static_cast<const gsBasePde<T>*>(&pde_)),
+          elimEntries(elimEntries_) {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
                     const index_t patchIndex,
@@ -47,7 +48,6 @@ public:
         lambda_inv = ( 1. + pr ) * ( 1. - 2. * pr ) / E / pr ;
         mu     = E / ( 2. * ( 1. + pr ) );
         forceScaling = options.getReal("ForceScaling");
-        I = gsMatrix<T>::Identity(dim,dim);
         // resize containers for global indices
         globalIndices.resize(dim+1);
         blockNumbers.resize(dim+1);
@@ -81,53 +81,10 @@ public:
     inline void assemble(gsDomainIterator<T> & element,
                          const gsVector<T> & quWeights)
     {
-        // Initialize local matrix/rhs                      // A | B^T
-        localMat.setZero(dim*N_D + N_P, dim*N_D + N_P);     // --|--    matrix structure
-        localRhs.setZero(dim*N_D + N_P,1);                  // B | C
-        // elasticity tensor
-        symmetricIdentityTensor<T>(C,I);
-        C *= mu;
-        // Loop over the quadrature nodes
-        for (index_t q = 0; q < quWeights.rows(); ++q)
-        {
-            // Multiply quadrature weight by the geometry measure
-            const T weight = quWeights[q] * md.measure(q);
-
-            // Compute physical gradients of basis functions at q as a dim x numActiveFunction matrix
-            transformGradients(md, q, basisValuesDisp[1], physGradDisp);
-            // A-matrix: Loop over displacement basis functions
-            for (index_t i = 0; i < N_D; i++)
-            {
-                setB<T>(B_i,I,physGradDisp.col(i));
-                tempK = B_i.transpose() * C;
-                // Loop over displacement basis functions
-                for (index_t j = 0; j < N_D; j++)
-                {
-                    setB<T>(B_j,I,physGradDisp.col(j));
-                    K = tempK * B_j;
-
-                    for (short_t di = 0; di < dim; ++di)
-                        for (short_t dj = 0; dj < dim; ++dj)
-                            localMat(di*N_D+i, dj*N_D+j) += weight * K(di,dj);
-                }
-            }
-            // B-matrix
-            for (short_t d = 0; d < dim; ++d)
-            {
-                block = weight*basisValuesPres.col(q)*physGradDisp.row(d);
-                localMat.block(dim*N_D,d*N_D,N_P,N_D) += block.block(0,0,N_P,N_D);
-                localMat.block(d*N_D,dim*N_D,N_D,N_P) += block.transpose().block(0,0,N_D,N_P);
-            }
-
-            // C-matrix
-            if (abs(lambda_inv) > 0)
-                localMat.block(dim*N_D,dim*N_D,N_P,N_P) -=
-                    (weight*lambda_inv*basisValuesPres.col(q)*basisValuesPres.col(q).transpose()).block(0,0,N_P,N_P);
-
-            // rhs contribution
-            for (short_t d = 0; d < dim; ++d)
-                localRhs.middleRows(d*N_D,N_D).noalias() += weight * forceScaling * forceValues(d,q) * basisValuesDisp[0].col(q) ;
-        }
+        if (dim == 2)
+            assembleElement<2>(quWeights);
+        else
+            assembleElement<3>(quWeights);
     }
 
     inline void localToGlobal(const int patchIndex,
@@ -146,9 +103,63 @@ public:
         // push to global system
         system.pushToRhs(localRhs,globalIndices,blockNumbers);
         system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
+        // push to the elimination system
+        if (elimEntries != nullptr)
+        {
+            localIndices.assign(dim,localIndicesDisp);
+            localIndices.push_back(localIndicesPres);
+            pushToEliminationEntries(localMat,localIndices,globalIndices,blockNumbers,eliminatedDofs,
+                                     system,patchIndex,*elimEntries);
+        }
     }
 
 protected:
+    // element matrix and rhs for a compile-time dimension d;
+    // the A-block is computed as a single dense product over all quadrature points like in gsVisitorLinearElasticity
+    template <short_t d>
+    void assembleElement(const gsVector<T> & quWeights)
+    {
+        const short_t dimTensor = d*(d+1)/2;
+        const index_t N_Q = quWeights.rows();
+        const gsMatrix<T,d,d> Ifixed = gsMatrix<T,d,d>::Identity();
+        // elasticity tensor
+        gsMatrix<T,d*(d+1)/2,d*(d+1)/2> Cfixed;
+        symmetricIdentityTensor<T>(Cfixed,Ifixed);
+        Cfixed *= mu;
+        // Initialize local matrix/rhs                      // A | B^T
+        localMat.setZero(d*N_D + N_P, d*N_D + N_P);         // --|--    matrix structure
+        localRhs.setZero(d*N_D + N_P,1);                    // B | C
+        Bstack.resize(N_Q*dimTensor,d*N_D);
+        CBstack.resize(N_Q*dimTensor,d*N_D);
+        // Loop over the quadrature nodes
+        for (index_t q = 0; q < N_Q; ++q)
+        {
+            // Multiply quadrature weight by the geometry measure
+            const T weight = quWeights[q] * md.measure(q);
+            // Compute physical gradients of basis functions at q as a dim x numActiveFunction matrix
+            transformGradients(md, q, basisValuesDisp[1], physGradDisp);
+            // A-matrix: B-matrices of all displacement basis functions at q
+            setBAll<T>(Bstack,q*dimTensor,Ifixed,physGradDisp);
+            CBstack.middleRows(q*dimTensor,dimTensor).noalias() = weight * Cfixed * Bstack.middleRows(q*dimTensor,dimTensor);
+            // B-matrix
+            for (short_t k = 0; k < d; ++k)
+            {
+                block.noalias() = weight*basisValuesPres.col(q)*physGradDisp.row(k);
+                localMat.block(d*N_D,k*N_D,N_P,N_D) += block;
+                localMat.block(k*N_D,d*N_D,N_D,N_P) += block.transpose();
+            }
+            // C-matrix
+            if (abs(lambda_inv) > 0)
+                localMat.block(d*N_D,d*N_D,N_P,N_P).noalias() -=
+                    weight*lambda_inv*basisValuesPres.col(q)*basisValuesPres.col(q).transpose();
+            // rhs contribution
+            for (short_t k = 0; k < d; ++k)
+                localRhs.middleRows(k*N_D,N_D).noalias() += weight * forceScaling * forceValues(k,q) * basisValuesDisp[0].col(q) ;
+        }
+        // A-matrix = B^T * C * B
+        localMat.topLeftCorner(d*N_D,d*N_D).noalias() += Bstack.transpose() * CBstack;
+    }
+
     // problem info
     short_t dim;
     const gsBasePde<T> * pde_ptr;
@@ -174,8 +185,11 @@ protected:
     gsMatrix<T> forceValues;
 
     // all temporary matrices defined here for efficiency
-    gsMatrix<T> C, physGradDisp, B_i, tempK, B_j, K, block, I;
-    // containers for global indices
+    gsMatrix<T> physGradDisp, block, Bstack, CBstack;
+    // entries of the elimination matrix to efficiently change Dirichlet degrees of freedom
+    gsSparseEntries<T> * elimEntries;
+    // containers for local (per block) and global indices
+    std::vector< gsMatrix<index_t> > localIndices;
     std::vector< gsMatrix<index_t> > globalIndices;
     gsVector<index_t> blockNumbers;
 };
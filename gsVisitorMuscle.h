@@ -18,6 +18,7 @@
 
 #include <gsElasticity/gsVisitorElUtils.h>
 #include <gsElasticity/gsBasePde.h>
+#include <gsElasticity/gsElementCache.h>
 
 #include <gsAssembler/gsQuadrature.h>
 #include <gsCore/gsFuncData.h>
@@ -33,12 +34,17 @@ public:
                     const gsPiecewiseFunction<T> & muscleTendon_,
                     const gsVector<T> & fiberDir_,
                     const gsMultiPatch<T> & displacement_,
-                    const gsMultiPatch<T> & pressure_)
+                    const gsMultiPatch<T> & pressure_,
+                    bool assembleMatrix_ = true,
+                    const gsElementCache<T> * elementCache_ = nullptr)
         : pde_ptr(static_cast<const gsBasePde<T>*>(&pde_)),
           muscleTendon(muscleTendon_),
           fiberDir(fiberDir_),
           displacement(displacement_),
-          pressure(pressure_){}
+          pressure(pressure_),
+          assembleMatrix(assembleMatrix_),
+          elementCache(elementCache_),
+          cached(nullptr) {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
                     const index_t patchIndex,
@@ -66,7 +72,6 @@ public:
         deltaW = options.getReal("DeltaW");
         powerNu = options.getReal("PowerNu");
         alpha = options.getReal("Alpha"); // activation parameter
-        I = gsMatrix<T>::Identity(dim,dim);
         // resize containers for global indices
         globalIndices.resize(dim+1);
         blockNumbers.resize(dim+1);
@@ -76,25 +81,35 @@ public:
                          const gsGeometry<T> & geo,
                          const gsMatrix<T> & quNodes)
     {
-        // store quadrature points of the element for geometry evaluation
-        md.points = quNodes;
-        // NEED_VALUE to get points in the physical domain for evaluation of the RHS
-        // NEED_MEASURE to get the Jacobian determinant values for integration
-        // NEED_GRAD_TRANSFORM to get the Jacobian matrix to transform gradient from the parametric to physical domain
-        md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
-        // Compute image of the quadrature points plus gradient, jacobian and other necessary data
-        geo.computeMap(md);
-        // find local indices of the displacement and pressure basis functions active on the element
-        basisRefs.front().active_into(quNodes.col(0),localIndicesDisp);
+        // geometry and basis data can be taken from the cache; then only the displacement and pressure are evaluated
+        cached = elementCache == nullptr ? nullptr : elementCache->find(patch,quNodes);
+        if (cached == nullptr)
+        {
+            // store quadrature points of the element for geometry evaluation
+            md.points = quNodes;
+            // NEED_VALUE to get points in the physical domain for evaluation of the RHS
+            // NEED_MEASURE to get the Jacobian determinant values for integration
+            // NEED_GRAD_TRANSFORM to get the Jacobian matrix to transform gradient from the parametric to physical domain
+            md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
+            // Compute image of the quadrature points plus gradient, jacobian and other necessary data
+            geo.computeMap(md);
+            // find local indices of the displacement and pressure basis functions active on the element
+            basisRefs.front().active_into(quNodes.col(0),localIndicesDisp);
+            basisRefs.back().active_into(quNodes.col(0), localIndicesPres);
+            // Evaluate displacement basis functions and their derivatives on the element
+            basisRefs.front().evalAllDers_into(quNodes,1,basisValuesDisp);
+            // Evaluate pressure basis functions on the element
+            basisRefs.back().eval_into(quNodes,basisValuesPres);
+        }
+        else
+        {
+            localIndicesDisp = cached->activesDisp;
+            localIndicesPres = cached->activesPres;
+        }
         N_D = localIndicesDisp.rows();
-        basisRefs.back().active_into(quNodes.col(0), localIndicesPres);
         N_P = localIndicesPres.rows();
-        // Evaluate displacement basis functions and their derivatives on the element
-        basisRefs.front().evalAllDers_into(quNodes,1,basisValuesDisp);
-        // Evaluate pressure basis functions on the element
-        basisRefs.back().eval_into(quNodes,basisValuesPres);
         // Evaluate right-hand side at the image of the quadrature points
-        pde_ptr->rhs()->eval_into(md.values[0],forceValues);
+        pde_ptr->rhs()->eval_into(cached == nullptr ? md.values[0] : cached->points,forceValues);
         // store quadrature points of the element for displacement evaluation
         mdDisplacement.points = quNodes;
         // NEED_DERIV to compute deformation gradient
@@ -111,121 +126,148 @@ public:
     inline void assemble(gsDomainIterator<T> & element,
                          const gsVector<T> & quWeights)
     {
+        if (dim == 2)
+            assembleElement<2>(quWeights);
+        else
+            assembleElement<3>(quWeights);
+    }
+
+    inline void localToGlobal(const int patchIndex,
+                              const std::vector<gsMatrix<T> > & eliminatedDofs,
+                              gsSparseSystem<T> & system)
+    {
+        // computes global indices for displacement components
+        for (short_t d = 0; d < dim; ++d)
+        {
+            system.mapColIndices(localIndicesDisp,patchIndex,globalIndices[d],d);
+            blockNumbers.at(d) = d;
+        }
+        // computes global indices for pressure
+        system.mapColIndices(localIndicesPres, patchIndex, globalIndices[dim], dim);
+        blockNumbers.at(dim) = dim;
+        // push to global system
+        system.pushToRhs(localRhs,globalIndices,blockNumbers);
+        if (assembleMatrix)
+            system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
+    }
+
+protected:
+    // element matrix and rhs for a compile-time dimension d; all point-wise tensors are fixed-size.
+    // The A-block is computed as dense products over all quadrature points like in gsVisitorNonLinearElasticity
+    template <short_t d>
+    void assembleElement(const gsVector<T> & quWeights)
+    {
+        const short_t dimTensor = d*(d+1)/2;
+        const index_t N_Q = quWeights.rows();
+        const gsMatrix<T,d,d> Ifixed = gsMatrix<T,d,d>::Identity();
+        gsMatrix<T,d,d> Ffixed, RCGfixed, RCGinvFixed, Sfixed, M, jacFixed, jacInvFixed;
+        gsMatrix<T,d*(d+1)/2,d*(d+1)/2> Cfixed, CtempFixed;
+        gsVector<T,d> fiberDirPhys;
         // Initialize local matrix/rhs                      // A | B^T
-        localMat.setZero(dim*N_D + N_P, dim*N_D + N_P);     // --|--    matrix structure
-        localRhs.setZero(dim*N_D + N_P,1);                  // B | C
+        if (assembleMatrix)                                 // --|--    matrix structure
+        {                                                   // B | C
+            localMat.setZero(d*N_D + N_P, d*N_D + N_P);
+            Bstack.resize(N_Q*dimTensor,d*N_D);
+            CBstack.resize(N_Q*dimTensor,d*N_D);
+            Gstack.resize(N_Q*d,N_D);
+            SGstack.resize(N_Q*d,N_D);
+        }
+        localRhs.setZero(d*N_D + N_P,1);
+        const gsMatrix<T> & valuesDisp = cached == nullptr ? basisValuesDisp[0] : cached->valuesDisp;
+        const gsMatrix<T> & valuesPres = cached == nullptr ? basisValuesPres : cached->valuesPres;
         // Loop over the quadrature nodes
-        for (index_t q = 0; q < quWeights.rows(); ++q)
+        for (index_t q = 0; q < N_Q; ++q)
         {
             // Compute material parameters
             const T mu = muscleTendonValues.at(q) * mu_muscle + (1-muscleTendonValues.at(q))*mu_tendon;
             const T lambda_inv = muscleTendonValues.at(q) * lambda_inv_muscle + (1-muscleTendonValues.at(q))*lambda_inv_tendon;
             // Multiply quadrature weight by the geometry measure
-            const T weight = quWeights[q] * md.measure(q);
-            // Compute physical gradients of basis functions at q as a dim x numActiveFunction matrix
-            transformGradients(md,q,basisValuesDisp[1],physGradDisp);
-            // physical jacobian of displacemnt du/dx = du/dxi * dxi/dx
-            physDispJac = mdDisplacement.jacobian(q)*(md.jacobian(q).cramerInverse());
-            // deformation gradient F = I + du/dx
-            F = I + physDispJac;
+            const T weight = quWeights[q] * (cached == nullptr ? md.measure(q) : cached->measures(q));
+            // Compute physical gradients of basis functions at q as a dim x numActiveFunction matrix,
+            // the geometry jacobian dx/dxi and its inverse
+            if (cached == nullptr)
+            {
+                transformGradients(md,q,basisValuesDisp[1],physGradDisp);
+                jacFixed = md.jacobian(q);
+                jacInvFixed = jacFixed.cramerInverse();
+            }
+            else
+            {
+                physGradDisp = cached->physGradsDisp.middleCols(q*N_D,N_D);
+                jacFixed = cached->jacobians.middleCols(q*d,d);
+                jacInvFixed = cached->jacobiansInv.middleCols(q*d,d);
+            }
+            // deformation gradient F = I + du/dx, where du/dx = du/dxi * dxi/dx
+            Ffixed = Ifixed + mdDisplacement.jacobian(q)*jacInvFixed;
             // deformation jacobian J = det(F)
-            T J = F.determinant();
+            T J = Ffixed.determinant();
             // Right Cauchy Green strain, C = F'*F
-            RCG = F.transpose() * F;
+            RCGfixed.noalias() = Ffixed.transpose() * Ffixed;
             // logarithmic neo-Hooke
             GISMO_ENSURE(J>0,"Invalid configuration: J < 0");
-            RCGinv = RCG.cramerInverse();
+            RCGinvFixed = RCGfixed.cramerInverse();
             // Second Piola-Kirchhoff stress tensor, passive part
-            S = (pressureValues.at(q)-mu)*RCGinv + mu*I;
+            Sfixed = (pressureValues.at(q)-mu)*RCGinvFixed + mu*Ifixed;
             /// active stress contribution - start
             // fiber direction in the physical domain
-            fiberDirPhys = md.jacobian(q)*fiberDir;
+            fiberDirPhys = jacFixed*fiberDir;
             fiberDirPhys /= fiberDirPhys.norm();
             // dyadic product of the fiber direction
-            M = fiberDirPhys * fiberDirPhys.transpose();
+            M.noalias() = fiberDirPhys * fiberDirPhys.transpose();
             // active stress scaled with the time activation parameter
-            T fiberStretch = sqrt((M*RCG).trace());
+            T fiberStretch = sqrt((M*RCGfixed).trace());
             T ratioInExp = (fiberStretch/optFiberStretch-1)/deltaW;
             T megaExp = exp(-1*pow(abs(ratioInExp),powerNu));
-            S += M * maxMuscleStress * alpha * muscleTendonValues.at(q)/ pow(fiberStretch,2) * megaExp;
+            Sfixed += M * maxMuscleStress * alpha * muscleTendonValues.at(q)/ pow(fiberStretch,2) * megaExp;
             /// active stress contribution - end
-            // elasticity tensor
-            symmetricIdentityTensor<T>(C,RCGinv);
-            C *= mu-pressureValues.at(q);
-            /// active stress contribution - start
-
-            matrixTraceTensor<T>(Ctemp,M,M);
-            C += -1*Ctemp*alpha*maxMuscleStress*megaExp/pow(fiberStretch,3)* muscleTendonValues.at(q)*
-                    (2 + powerNu*pow(ratioInExp,powerNu-1)/deltaW/optFiberStretch);
-            /// active stress contribution - end
-            // Matrix A and reisdual: loop over displacement basis functions
-            for (index_t i = 0; i < N_D; i++)
+            if (assembleMatrix)
             {
-                setB<T>(B_i,F,physGradDisp.col(i));
-                materialTangentTemp = B_i.transpose() * C;
-                // Geometric tangent K_tg_geo = gradB_i^T * S * gradB_j;
-                geometricTangentTemp = S * physGradDisp.col(i);
-                // A-matrix
-                for (index_t j = 0; j < N_D; j++)
+                // elasticity tensor
+                symmetricIdentityTensor<T>(Cfixed,RCGinvFixed);
+                Cfixed *= mu-pressureValues.at(q);
+                /// active stress contribution - start
+                matrixTraceTensor<T>(CtempFixed,M,M);
+                Cfixed += -1*CtempFixed*alpha*maxMuscleStress*megaExp/pow(fiberStretch,3)* muscleTendonValues.at(q)*
+                        (2 + powerNu*pow(ratioInExp,powerNu-1)/deltaW/optFiberStretch);
+                /// active stress contribution - end
+                // A-matrix: material and geometric tangent at q for all basis functions at once
+                setBAll<T>(Bstack,q*dimTensor,Ffixed,physGradDisp);
+                CBstack.middleRows(q*dimTensor,dimTensor).noalias() = weight * Cfixed * Bstack.middleRows(q*dimTensor,dimTensor);
+                Gstack.middleRows(q*d,d) = physGradDisp;
+                SGstack.middleRows(q*d,d).noalias() = weight * Sfixed * physGradDisp;
+                // B-matrix
+                divV.noalias() = Ffixed.cramerInverse().transpose() * physGradDisp;
+                for (short_t k = 0; k < d; ++k)
                 {
-                    setB<T>(B_j,F,physGradDisp.col(j));
-                    materialTangent = materialTangentTemp * B_j;
-                    T geometricTangent =  geometricTangentTemp.transpose() * physGradDisp.col(j);
-                    // K_tg = K_tg_mat + I*K_tg_geo;
-                    for (short_t d = 0; d < dim; ++d)
-                        materialTangent(d,d) += geometricTangent;
-
-                    for (short_t di = 0; di < dim; ++di)
-                        for (short_t dj = 0; dj < dim; ++dj)
-                            localMat(di*N_D+i, dj*N_D+j) += weight * materialTangent(di,dj);
+                    block.noalias() = weight*valuesPres.col(q)*divV.row(k);
+                    localMat.block(d*N_D,k*N_D,N_P,N_D) += block;
+                    localMat.block(k*N_D,d*N_D,N_D,N_P) += block.transpose();
                 }
-
-                // Second Piola-Kirchhoff stress tensor as vector
-                voigtStress<T>(Svec,S);
-                // rhs = -r = force - B*Svec,
-                localResidual = B_i.transpose() * Svec;
-                for (short_t d = 0; d < dim; d++)
-                    localRhs(d*N_D+i) -= weight * localResidual(d);
-            }
-            // B-matrix
-            divV = F.cramerInverse().transpose() * physGradDisp;
-            for (short_t d = 0; d < dim; ++d)
-            {
-                block = weight*basisValuesPres.col(q)*divV.row(d);
-                localMat.block(dim*N_D,d*N_D,N_P,N_D) += block.block(0,0,N_P,N_D);
-                localMat.block(d*N_D,dim*N_D,N_D,N_P) += block.transpose().block(0,0,N_D,N_P);
+                // C-matrix
+                if (abs(lambda_inv) > 0)
+                    localMat.block(d*N_D,d*N_D,N_P,N_P).noalias() -=
+                            weight*lambda_inv*valuesPres.col(q)*valuesPres.col(q).transpose();
             }
-            // C-matrix
-            if (abs(lambda_inv) > 0)
-                localMat.block(dim*N_D,dim*N_D,N_P,N_P) -=
-                        (weight*lambda_inv*basisValuesPres.col(q)*basisValuesPres.col(q).transpose()).block(0,0,N_P,N_P);
+            // rhs = -r = force - B^T*Svec, where B_i^T * Svec = F * S * gradN_i for all basis functions at once
+            residualTemp.noalias() = Ffixed * Sfixed * physGradDisp;
+            for (short_t k = 0; k < d; ++k)
+                localRhs.middleRows(k*N_D,N_D).noalias() -= weight * residualTemp.row(k).transpose();
             // rhs: constraint residual
-            localRhs.middleRows(dim*N_D,N_P) += weight*basisValuesPres.col(q)*(lambda_inv*pressureValues.at(q)-log(J));
+            localRhs.middleRows(d*N_D,N_P) += weight*valuesPres.col(q)*(lambda_inv*pressureValues.at(q)-log(J));
             // rhs: force
-            for (short_t d = 0; d < dim; ++d)
-                localRhs.middleRows(d*N_D,N_D).noalias() += weight * forceScaling * forceValues(d,q) * basisValuesDisp[0].col(q) ;
+            for (short_t k = 0; k < d; ++k)
+                localRhs.middleRows(k*N_D,N_D).noalias() += weight * forceScaling * forceValues(k,q) * valuesDisp.col(q) ;
         }
-    }
-
-    inline void localToGlobal(const int patchIndex,
-                              const std::vector<gsMatrix<T> > & eliminatedDofs,
-                              gsSparseSystem<T> & system)
-    {
-        // computes global indices for displacement components
-        for (short_t d = 0; d < dim; ++d)
+        if (assembleMatrix)
         {
-            system.mapColIndices(localIndicesDisp,patchIndex,globalIndices[d],d);
-            blockNumbers.at(d) = d;
+            // A = K_tg_mat + I*K_tg_geo
+            localMat.topLeftCorner(d*N_D,d*N_D).noalias() += Bstack.transpose() * CBstack;
+            geometricTangent.noalias() = Gstack.transpose() * SGstack;
+            for (short_t k = 0; k < d; ++k)
+                localMat.block(k*N_D,k*N_D,N_D,N_D) += geometricTangent;
         }
-        // computes global indices for pressure
-        system.mapColIndices(localIndicesPres, patchIndex, globalIndices[dim], dim);
-        blockNumbers.at(dim) = dim;
-        // push to global system
-        system.pushToRhs(localRhs,globalIndices,blockNumbers);
-        system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
     }
 
-protected:
     // problem info
     short_t dim;
     const gsBasePde<T> * pde_ptr;
@@ -264,12 +306,17 @@ protected:
     const gsMultiPatch<T> & pressure;
     // evaluation data of the current pressure field stored as a 1 x numQuadPoints matrix
     gsMatrix<T> pressureValues;
+    // switch between assembling the full system or only the residual
+    bool assembleMatrix;
+    // optional cache of geometry and basis evaluations and the data of the current element (nullptr if not cached)
+    const gsElementCache<T> * elementCache;
+    const typename gsElementCache<T>::Element * cached;
     // evaluation data of the muscle-tendon distribution stored as a 1 x numQuadPoints matrix
     gsMatrix<T> muscleTendonValues;
 
     // all temporary matrices defined here for efficiency
-    gsMatrix<T> C, Ctemp, physGradDisp, physDispJac, F, RCG, E, S, RCGinv, B_i, materialTangentTemp, B_j, materialTangent, divV, block, I, M;
-    gsVector<T> geometricTangentTemp, Svec, localResidual, fiberDirPhys;
+    gsMatrix<T> physGradDisp, divV, block, residualTemp;
+    gsMatrix<T> Bstack, CBstack, Gstack, SGstack, geometricTangent;
     // containers for global indices
     std::vector< gsMatrix<index_t> > globalIndices;
     gsVector<index_t> blockNumbers;
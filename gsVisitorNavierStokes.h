@@ -19,6 +19,7 @@
 #include <algorithm>
 
 #include <gsElasticity/gsBasePde.h>
+#include <gsElasticity/gsVisitorElUtils.h>
 
 namespace gismo
 {
@@ -29,10 +30,13 @@ class gsVisitorNavierStokes
 public:
 
     gsVisitorNavierStokes(const gsPde<T> & pde_, const gsMultiPatch<T> & velocity_,
-                          const gsMultiPatch<T> & pressure_)
+                          const gsMultiPatch<T> & pressure_, bool assembleMatrix_ = true,
+                          gsSparseEntries<T> * elimEntries_ = nullptr)
         : pde_ptr(static_cast<const gsBasePde<T>*>(&pde_)),
           velocity(velocity_),
-          pressure(pressure_) {}
+          pressure(pressure_),
+          assembleMatrix(assembleMatrix_),
+          elimEntries(elimEntries_) {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
                     const index_t patchIndex,
@@ -96,10 +100,11 @@ public:
     inline void assemble(gsDomainIterator<T> & element,
                          const gsVector<T> & quWeights)
     {
-        if (assemblyType == 0)
-            assembleOseen(element,quWeights);
-        else if (assemblyType == 1)
+        // the residual alone is the rhs of the Newton's update
+        if (!assembleMatrix || assemblyType == 1)
             assembleNewtonUpdate(element,quWeights);
+        else if (assemblyType == 0)
+            assembleOseen(element,quWeights);
         else if (assemblyType == 2)
             assembleNewtonFull(element,quWeights);
     }
@@ -119,17 +124,29 @@ public:
         blockNumbers.at(dim) = dim;
         // push to global system
         system.pushToRhs(localRhs,globalIndices,blockNumbers);
-        system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
+        if (assembleMatrix)
+            system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
+        // push to the elimination system
+        if (assembleMatrix && elimEntries != nullptr)
+        {
+            localIndices.assign(dim,localIndicesVel);
+            localIndices.push_back(localIndicesPres);
+            pushToEliminationEntries(localMat,localIndices,globalIndices,blockNumbers,eliminatedDofs,
+                                     system,patchIndex,*elimEntries);
+        }
     }
 
 protected:
 
+    // the matrix is skipped if only the residual is assembled
     void assembleNewtonUpdate(gsDomainIterator<T> & element,
                               const gsVector<T> & quWeights)
     {
         // Initialize local matrix/rhs                     // A | D
-        localMat.setZero(dim*N_V + N_P, dim*N_V + N_P);    // --|--    matrix structure
-        localRhs.setZero(dim*N_V + N_P,1);                 // B | 0// roughly estimate h - diameter of the element ( for SUPG)
+        if (assembleMatrix)                                // --|--    matrix structure
+            localMat.setZero(dim*N_V + N_P, dim*N_V + N_P);    // B | 0
+        localRhs.setZero(dim*N_V + N_P,1);
+        // roughly estimate h - diameter of the element ( for SUPG)
         // T h = cellSize(element);
         // Loop over the quadrature nodes
         for (index_t q = 0; q < quWeights.rows(); ++q)
@@ -140,25 +157,28 @@ protected:
             transformGradients(md, q, basisValuesVel[1], physGradVel);
             // Compute physical Jacobian of the current velocity field
             physJacCurVel = mdVelocity.jacobian(q)*(md.jacobian(q).cramerInverse()); 
-            // matrix A: diffusion
-            block = weight*density*viscosity * physGradVel.transpose()*physGradVel;
-            for (short_t d = 0; d < dim; ++d)
-                localMat.block(d*N_V,d*N_V,N_V,N_V) += block.block(0,0,N_V,N_V);
-            // matrix A: advection
-            block = weight*basisValuesVel[0].col(q) * (mdVelocity.values[0].col(q).transpose()*physGradVel);
-            for (short_t d = 0; d < dim; ++d)
-                localMat.block(d*N_V,d*N_V,N_V,N_V) += density*block.block(0,0,N_V,N_V);
-            // matrix A: reaction
-            block = weight*density*basisValuesVel[0].col(q) * basisValuesVel[0].col(q).transpose();
-            for (short_t di = 0; di < dim; ++di)
-                for (short_t dj = 0; dj < dim; ++dj)
-                    localMat.block(di*N_V,dj*N_V,N_V,N_V) += physJacCurVel(di,dj)*block.block(0,0,N_V,N_V);
-            // matrices B and D
-            for (short_t d = 0; d < dim; ++d)
+            if (assembleMatrix)
             {
-                block = weight*basisValuesPres.col(q)*physGradVel.row(d);
-                localMat.block(dim*N_V,d*N_V,N_P,N_V) -= block.block(0,0,N_P,N_V); // B
-                localMat.block(d*N_V,dim*N_V,N_V,N_P) -= block.transpose().block(0,0,N_V,N_P); // D
+                // matrix A: diffusion
+                block = weight*density*viscosity * physGradVel.transpose()*physGradVel;
+                for (short_t d = 0; d < dim; ++d)
+                    localMat.block(d*N_V,d*N_V,N_V,N_V) += block.block(0,0,N_V,N_V);
+                // matrix A: advection
+                block = weight*basisValuesVel[0].col(q) * (mdVelocity.values[0].col(q).transpose()*physGradVel);
+                for (short_t d = 0; d < dim; ++d)
+                    localMat.block(d*N_V,d*N_V,N_V,N_V) += density*block.block(0,0,N_V,N_V);
+                // matrix A: reaction
+                block = weight*density*basisValuesVel[0].col(q) * basisValuesVel[0].col(q).transpose();
+                for (short_t di = 0; di < dim; ++di)
+                    for (short_t dj = 0; dj < dim; ++dj)
+                        localMat.block(di*N_V,dj*N_V,N_V,N_V) += physJacCurVel(di,dj)*block.block(0,0,N_V,N_V);
+                // matrices B and D
+                for (short_t d = 0; d < dim; ++d)
+                {
+                    block = weight*basisValuesPres.col(q)*physGradVel.row(d);
+                    localMat.block(dim*N_V,d*N_V,N_P,N_V) -= block.block(0,0,N_P,N_V); // B
+                    localMat.block(d*N_V,dim*N_V,N_V,N_P) -= block.transpose().block(0,0,N_V,N_P); // D
+                }
             }
             // rhs: force
             for (short_t d = 0; d < dim; ++d)
@@ -308,10 +328,15 @@ protected:
     gsMatrix<T> pressureValues;
     // pressure gradients at the current element (only for supg); stored as a dim x numQuadPoints matrix
     gsMatrix<T> pressureGrads;
+    // switch between assembling the full system or only the residual (Newton update form)
+    bool assembleMatrix;
+    // entries of the elimination matrix, i.e. the derivative of the residual w.r.t. Dirichlet DoFs
+    gsSparseEntries<T> * elimEntries;
 
     // all temporary matrices defined here for efficiency
     gsMatrix<T> block, physGradVel, physJacCurVel;
-    // containers for global indices
+    // containers for local (per block) and global indices
+    std::vector< gsMatrix<index_t> > localIndices;
     std::vector< gsMatrix<index_t> > globalIndices;
     gsVector<index_t> blockNumbers;
 };
@@ -17,6 +17,7 @@
 
 #include <gsElasticity/gsVisitorElUtils.h>
 #include <gsElasticity/gsBasePde.h>
+#include <gsElasticity/gsElementCache.h>
 
 #include <gsAssembler/gsQuadrature.h>
 #include <gsCore/gsFuncData.h>
@@ -28,9 +29,18 @@ template <class T>
 class gsVisitorNonLinearElasticity
 {
 public:
-    gsVisitorNonLinearElasticity(const gsPde<T> & pde_, const gsMultiPatch<T> & displacement_)
+    gsVisitorNonLinearElasticity(const gsPde<T> & pde_, const gsMultiPatch<T> & displacement_,
+                                 bool assembleMatrix_ = true,
+                                 const gsElementCache<T> * elementCache_ = nullptr,
+                                 const gsMultiPatch<T> * direction_ = nullptr,
+                                 bool diagonal_ = false)
         : pde_ptr(static_cast<const gsBasePde<T>*>(&pde_)),
-          displacement(displacement_) { }
+          displacement(displacement_),
+          assembleMatrix(assembleMatrix_ && direction_ == nullptr && !diagonal_),
+          elementCache(elementCache_),
+          cached(nullptr),
+          direction(direction_),
+          diagonal(diagonal_ && direction_ == nullptr) { }
 
     void initialize(const gsBasisRefs<T> & basisRefs,
                     const index_t patchIndex,
@@ -68,128 +78,208 @@ public:
                          const gsGeometry<T> & geo,
                          const gsMatrix<T> & quNodes)
     {
-        // store quadrature points of the element for geometry evaluation
-        md.points = quNodes;
-        // NEED_VALUE to get points in the physical domain for evaluation of the RHS
-        // NEED_MEASURE to get the Jacobian determinant values for integration
-        // NEED_GRAD_TRANSFORM to get the Jacobian matrix to transform gradient from the parametric to physical domain
-        md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
-        // Compute image of the quadrature points plus gradient, jacobian and other necessary data
-        geo.computeMap(md);
-        // find local indices of the displacement basis functions active on the element
-        basisRefs.front().active_into(quNodes.col(0),localIndicesDisp);
+        // geometry and basis data can be taken from the cache; then only the displacement is evaluated
+        cached = elementCache == nullptr ? nullptr : elementCache->find(patch,quNodes);
+        if (cached == nullptr)
+        {
+            // store quadrature points of the element for geometry evaluation
+            md.points = quNodes;
+            // NEED_VALUE to get points in the physical domain for evaluation of the RHS
+            // NEED_MEASURE to get the Jacobian determinant values for integration
+            // NEED_GRAD_TRANSFORM to get the Jacobian matrix to transform gradient from the parametric to physical domain
+            md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
+            // Compute image of the quadrature points plus gradient, jacobian and other necessary data
+            geo.computeMap(md);
+            // find local indices of the displacement basis functions active on the element
+            basisRefs.front().active_into(quNodes.col(0),localIndicesDisp);
+            // Evaluate displacement basis functions and their derivatives on the element
+            basisRefs.front().evalAllDers_into(quNodes,1,basisValuesDisp);
+        }
+        else
+            localIndicesDisp = cached->activesDisp;
         N_D = localIndicesDisp.rows();
-        // Evaluate displacement basis functions and their derivatives on the element
-        basisRefs.front().evalAllDers_into(quNodes,1,basisValuesDisp);
         // Evaluate right-hand side at the image of the quadrature points
-        pde_ptr->rhs()->eval_into(md.values[0],forceValues);
+        pde_ptr->rhs()->eval_into(cached == nullptr ? md.values[0] : cached->points,forceValues);
         // store quadrature points of the element for displacement evaluation
         mdDisplacement.points = quNodes;
         // NEED_DERIV to compute deformation gradient
         mdDisplacement.flags = NEED_DERIV;
         // evaluate displacement gradient
         displacement.patch(patch).computeMap(mdDisplacement);
+        // evaluate the gradient of the direction for the matrix-free tangent
+        if (direction != nullptr)
+        {
+            mdDirection.points = quNodes;
+            mdDirection.flags = NEED_DERIV;
+            direction->patch(patch).computeMap(mdDirection);
+        }
     }
 
     inline void assemble(gsDomainIterator<T> & element,
                          const gsVector<T> & quWeights)
     {
-        // initialize local matrix and rhs
-        localMat.setZero(dim*N_D,dim*N_D);
-        localRhs.setZero(dim*N_D,1);
+        if (dim == 2)
+            assembleElement<2>(quWeights);
+        else
+            assembleElement<3>(quWeights);
+    }
+
+    inline void localToGlobal(const int patchIndex,
+                              const std::vector<gsMatrix<T> > & eliminatedDofs,
+                              gsSparseSystem<T> & system)
+    {
+        // computes global indices for displacement components
+        for (short_t d = 0; d < dim; ++d)
+        {
+            system.mapColIndices(localIndicesDisp, patchIndex, globalIndices[d], d);
+            blockNumbers.at(d) = d;
+        }
+        // push to global system
+        system.pushToRhs(localRhs,globalIndices,blockNumbers);
+        if (assembleMatrix)
+            system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
+    }
+
+protected:
+    // element tangent matrix as dense products over all quadrature points:
+    // K = sum_q w_q * (B_q^T * C_q * B_q + I x G_q^T * S_q * G_q),
+    // where B_q contains B-matrices of all active basis functions (see setBAll) and G_q their physical gradients
+    template <short_t d>
+    void assembleElement(const gsVector<T> & quWeights)
+    {
+        const short_t dimTensor = d*(d+1)/2;
+        const index_t N_Q = quWeights.rows();
+        const gsMatrix<T,d,d> Ifixed = gsMatrix<T,d,d>::Identity();
+        gsMatrix<T,d,d> Ffixed, RCGfixed, RCGinvFixed, Efixed, Sfixed, jacInvFixed, gradVfixed, dHfixed, dSfixed;
+        gsMatrix<T,d*(d+1)/2,d*(d+1)/2> Cfixed, CtempFixed;
+        gsVector<T,d*(d+1)/2> dEvec, dSvec;
+        // the elasticity tensor is needed for the tangent matrix, the matrix-free tangent and its diagonal
+        const bool tangent = assembleMatrix || direction != nullptr || diagonal;
+        if (materialLaw == 0)
+            Cfixed = C;
+        // initialize stacked matrices and rhs
+        if (assembleMatrix)
+        {
+            Bstack.resize(N_Q*dimTensor,d*N_D);
+            CBstack.resize(N_Q*dimTensor,d*N_D);
+            Gstack.resize(N_Q*d,N_D);
+            SGstack.resize(N_Q*d,N_D);
+        }
+        if (diagonal)
+        {
+            Bstack.resize(dimTensor,d*N_D);
+            CBstack.resize(dimTensor,d*N_D);
+        }
+        localRhs.setZero(d*N_D,1);
+        const gsMatrix<T> & valuesDisp = cached == nullptr ? basisValuesDisp[0] : cached->valuesDisp;
         // loop over quadrature nodes
-        for (index_t q = 0; q < quWeights.rows(); ++q)
+        for (index_t q = 0; q < N_Q; ++q)
         {
-            const T weightForce = quWeights[q] * md.measure(q);
+            const T measure = cached == nullptr ? md.measure(q) : cached->measures(q);
+            const T weightForce = quWeights[q] * measure;
             // Compute physical gradients of basis functions at q as a dim x numActiveFunction matrix
-            transformGradients(md,q,basisValuesDisp[1],physGrad);
-            // physical jacobian of displacemnt du/dx = du/dxi * dxi/dx
-            physDispJac = mdDisplacement.jacobian(q)*(md.jacobian(q).cramerInverse());
-            // deformation gradient F = I + du/dx
-            F = I + physDispJac;
+            // and the inverse of the geometry jacobian dxi/dx
+            if (cached == nullptr)
+            {
+                transformGradients(md,q,basisValuesDisp[1],physGrad);
+                jacInvFixed = md.jacobian(q).cramerInverse();
+            }
+            else
+            {
+                physGrad = cached->physGradsDisp.middleCols(q*N_D,N_D);
+                jacInvFixed = cached->jacobiansInv.middleCols(q*d,d);
+            }
+            // deformation gradient F = I + du/dx, where du/dx = du/dxi * dxi/dx
+            Ffixed = Ifixed + mdDisplacement.jacobian(q)*jacInvFixed;
             // deformation jacobian J = det(F)
-            T J = F.determinant();
+            T J = Ffixed.determinant();
             // Right Cauchy Green strain, C = F'*F
-            RCG = F.transpose() * F;
+            RCGfixed.noalias() = Ffixed.transpose() * Ffixed;
             // Green-Lagrange strain, E = 0.5*(C-I), a.k.a. full geometric strain tensor
-            E = 0.5 * (RCG - I);
-            const T weightBody = quWeights[q] * pow(md.measure(q),-1.*localStiffening) * md.measure(q);
+            Efixed = 0.5 * (RCGfixed - Ifixed);
+            const T weightBody = quWeights[q] * pow(measure,-1.*localStiffening) * measure;
             // Second Piola-Kirchhoff stress tensor
             if (materialLaw == 0) // Saint Venant-Kirchhoff
-                S = lambda*E.trace()*I + 2*mu*E;
+                Sfixed = lambda*Efixed.trace()*Ifixed + 2*mu*Efixed;
             if (materialLaw == 1) // neo-Hooke ln(J)
             {
                 GISMO_ENSURE(J>0,"Invalid configuration: J < 0");
-                RCGinv = RCG.cramerInverse();
-                S = (lambda*log(J)-mu)*RCGinv + mu*I;
+                RCGinvFixed = RCGfixed.cramerInverse();
+                Sfixed = (lambda*log(J)-mu)*RCGinvFixed + mu*Ifixed;
                 // elasticity tensor
-                matrixTraceTensor<T>(C,RCGinv,RCGinv);
-                C *= lambda;
-                symmetricIdentityTensor<T>(Ctemp,RCGinv);
-                C += (mu-lambda*log(J))*Ctemp;
+                if (tangent)
+                {
+                    matrixTraceTensor<T>(Cfixed,RCGinvFixed,RCGinvFixed);
+                    Cfixed *= lambda;
+                    symmetricIdentityTensor<T>(CtempFixed,RCGinvFixed);
+                    Cfixed += (mu-lambda*log(J))*CtempFixed;
+                }
             }
             if (materialLaw == 2) // quad neo-Hooke
             {
-                RCGinv = RCG.cramerInverse();
-                S = (lambda*(J*J-1)/2-mu)*RCGinv + mu*I;
+                RCGinvFixed = RCGfixed.cramerInverse();
+                Sfixed = (lambda*(J*J-1)/2-mu)*RCGinvFixed + mu*Ifixed;
                 // elasticity tensor
-                matrixTraceTensor<T>(C,RCGinv,RCGinv);
-                C *= lambda*J*J;
-                symmetricIdentityTensor<T>(Ctemp,RCGinv);
-                C += (mu-lambda*(J*J-1)/2)*Ctemp;
-            }
-            // loop over active basis functions (u_i)
-            for (index_t i = 0; i < N_D; i++)
-            {
-                // Material tangent K_tg_mat = B_i^T * C * B_j;
-                setB<T>(B_i,F,physGrad.col(i));
-                materialTangentTemp = B_i.transpose() * C;
-                // Geometric tangent K_tg_geo = gradB_i^T * S * gradB_j;
-                geometricTangentTemp = S * physGrad.col(i);
-                // loop over active basis functions (v_j)
-                for (index_t j = 0; j < N_D; j++)
+                if (tangent)
                 {
-                    setB<T>(B_j,F,physGrad.col(j));
-
-                    materialTangent = materialTangentTemp * B_j;
-                    T geometricTangent =  geometricTangentTemp.transpose() * physGrad.col(j);
-                    // K_tg = K_tg_mat + I*K_tg_geo;
-                    for (short_t d = 0; d < dim; ++d)
-                        materialTangent(d,d) += geometricTangent;
-
-                    for (short_t di = 0; di < dim; ++di)
-                        for (short_t dj = 0; dj < dim; ++dj)
-                            localMat(di*N_D+i, dj*N_D+j) += weightBody * materialTangent(di,dj);
+                    matrixTraceTensor<T>(Cfixed,RCGinvFixed,RCGinvFixed);
+                    Cfixed *= lambda*J*J;
+                    symmetricIdentityTensor<T>(CtempFixed,RCGinvFixed);
+                    Cfixed += (mu-lambda*(J*J-1)/2)*CtempFixed;
                 }
-                // Second Piola-Kirchhoff stress tensor as vector
-                voigtStress<T>(Svec,S);
-                // rhs = -r = force - B*Svec,
-                localResidual = B_i.transpose() * Svec;
-                for (short_t d = 0; d < dim; d++)
-                    localRhs(d*N_D+i) -= weightBody * localResidual(d);
             }
+            if (assembleMatrix)
+            {
+                // material tangent: B-matrices and their product with the weighted elasticity tensor
+                setBAll<T>(Bstack,q*dimTensor,Ffixed,physGrad);
+                CBstack.middleRows(q*dimTensor,dimTensor).noalias() = weightBody * Cfixed * Bstack.middleRows(q*dimTensor,dimTensor);
+                // geometric tangent: gradients and their product with the weighted stress tensor
+                Gstack.middleRows(q*d,d) = physGrad;
+                SGstack.middleRows(q*d,d).noalias() = weightBody * Sfixed * physGrad;
+            }
+            if (direction != nullptr)
+            {
+                // matrix-free tangent K*v = B^T*C*B*v + gradV*S*gradN = (F*dS + gradV*S)*gradN,
+                // where B*v = sym(F^T*gradV) in Voigt notation and dS = C*B*v
+                gradVfixed = mdDirection.jacobian(q)*jacInvFixed;
+                dHfixed.noalias() = Ffixed.transpose()*gradVfixed;
+                voigtStrain<T>(dEvec,dHfixed);
+                dSvec.noalias() = Cfixed*dEvec;
+                voigtToTensor<T>(dSfixed,dSvec);
+                residualTemp.noalias() = (Ffixed * dSfixed + gradVfixed * Sfixed) * physGrad;
+                for (short_t k = 0; k < d; ++k)
+                    localRhs.middleRows(k*N_D,N_D).noalias() += weightBody * residualTemp.row(k).transpose();
+                continue;
+            }
+            if (diagonal)
+            {
+                // diagonal of the tangent (B_i^T*C*B_i)_aa + gradN_i^T*S*gradN_i for all basis functions at once
+                setBAll<T>(Bstack,0,Ffixed,physGrad);
+                CBstack.noalias() = Cfixed * Bstack;
+                diagonalTemp.noalias() = Bstack.cwiseProduct(CBstack).colwise().sum().transpose();
+                geometricDiagonal.noalias() = physGrad.cwiseProduct(Sfixed * physGrad).colwise().sum().transpose();
+                for (short_t k = 0; k < d; ++k)
+                    localRhs.middleRows(k*N_D,N_D).noalias() += weightBody * (diagonalTemp.middleRows(k*N_D,N_D) + geometricDiagonal);
+                continue;
+            }
+            // rhs = -r = force - B^T*Svec, where B_i^T * Svec = F * S * gradN_i for all basis functions at once
+            residualTemp.noalias() = Ffixed * Sfixed * physGrad;
+            for (short_t k = 0; k < d; ++k)
+                localRhs.middleRows(k*N_D,N_D).noalias() -= weightBody * residualTemp.row(k).transpose();
             // contribution of volumetric load function to residual/rhs
-            for (short_t d = 0; d < dim; ++d)
-                localRhs.middleRows(d*N_D,N_D).noalias() += weightForce * forceScaling * forceValues(d,q) * basisValuesDisp[0].col(q);
+            for (short_t k = 0; k < d; ++k)
+                localRhs.middleRows(k*N_D,N_D).noalias() += weightForce * forceScaling * forceValues(k,q) * valuesDisp.col(q);
         }
-    }
-
-    inline void localToGlobal(const int patchIndex,
-                              const std::vector<gsMatrix<T> > & eliminatedDofs,
-                              gsSparseSystem<T> & system)
-    {
-        // computes global indices for displacement components
-        for (short_t d = 0; d < dim; ++d)
+        if (assembleMatrix)
         {
-            system.mapColIndices(localIndicesDisp, patchIndex, globalIndices[d], d);
-            blockNumbers.at(d) = d;
+            // K_tg = K_tg_mat + I*K_tg_geo
+            localMat.noalias() = Bstack.transpose() * CBstack;
+            geometricTangent.noalias() = Gstack.transpose() * SGstack;
+            for (short_t k = 0; k < d; ++k)
+                localMat.block(k*N_D,k*N_D,N_D,N_D) += geometricTangent;
         }
-        // push to global system
-        system.pushToRhs(localRhs,globalIndices,blockNumbers);
-        system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
     }
 
-protected:
     // problem info
     short_t dim;
     index_t patch; // current patch
@@ -215,10 +305,21 @@ protected:
     const gsMultiPatch<T> & displacement;
     // evaluation data of the current displacement field
     gsMapData<T> mdDisplacement;
+    // switch between assembling the full system or only the residual
+    bool assembleMatrix;
+    // optional cache of geometry and basis evaluations and the data of the current element (nullptr if not cached)
+    const gsElementCache<T> * elementCache;
+    const typename gsElementCache<T>::Element * cached;
+    // direction for the matrix-free tangent; if given, the visitor assembles K*direction into the rhs
+    const gsMultiPatch<T> * direction;
+    // evaluation data of the direction
+    gsMapData<T> mdDirection;
+    // if true, the visitor assembles the diagonal of the tangent matrix into the rhs
+    bool diagonal;
 
     // all temporary matrices defined here for efficiency
-    gsMatrix<T> C, Ctemp, physGrad, physDispJac, F, RCG, E, S, RCGinv, B_i, materialTangentTemp, B_j, materialTangent, I;
-    gsVector<T> geometricTangentTemp, Svec, localResidual;
+    gsMatrix<T> C, Ctemp, physGrad, I, residualTemp;
+    gsMatrix<T> Bstack, CBstack, Gstack, SGstack, geometricTangent, diagonalTemp, geometricDiagonal;
     T localStiffening;
     // containers for global indices
     std::vector< gsMatrix<index_t> > globalIndices;
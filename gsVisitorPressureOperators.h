@@ -0,0 +1,152 @@
+/** @file gsVisitorPressureOperators.h
+
+    @brief Visitor class for operators on the pressure space of mixed formulations,
+    used by Schur complement preconditioners.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s):
+        A.Shamanskiy (2016 - ...., TU Kaiserslautern)
+*/
+
+#pragma once
+
+#include <gsAssembler/gsQuadrature.h>
+#include <gsCore/gsFuncData.h>
+
+namespace gismo
+{
+
+/** @brief Assembles the pressure mass matrix and, optionally, the pressure Laplacian and the pressure
+ * convection-diffusion operator F_p = density*(viscosity*Laplacian + velocity*grad).
+ *
+ * The pressure is the last unknown of the system. The operators are written to separate triplet containers
+ * in the numbering of free pressure DoFs; the global system is not modified.
+*/
+template <class T>
+class gsVisitorPressureOperators
+{
+public:
+
+    gsVisitorPressureOperators(gsSparseEntries<T> & mass_,
+                               gsSparseEntries<T> * laplacian_ = nullptr,
+                               gsSparseEntries<T> * convDiff_ = nullptr,
+                               const gsMultiPatch<T> * velocity_ = nullptr,
+                               T viscosity_ = 0., T density_ = 1.)
+        : mass(&mass_),
+          laplacian(laplacian_),
+          convDiff(convDiff_),
+          velocity(velocity_),
+          viscosity(viscosity_),
+          density(density_)
+    {}
+
+    void initialize(const gsBasisRefs<T> & basisRefs,
+                    const index_t patchIndex,
+                    const gsOptionList & options,
+                    gsQuadRule<T> & rule)
+    {
+        // parametric dimension of the first velocity/displacement component
+        dim = basisRefs.front().dim();
+        // the same quadrature rule as for the system assembly
+        rule = gsQuadrature::get(basisRefs.front(), options);
+        // evaluate velocity and derivatives only if necessary
+        needGrads = laplacian || convDiff;
+        patch = patchIndex;
+    }
+
+    inline void evaluate(const gsBasisRefs<T> & basisRefs,
+                         const gsGeometry<T> & geo,
+                         const gsMatrix<T> & quNodes)
+    {
+        // store quadrature points of the element for geometry evaluation
+        md.points = quNodes;
+        // NEED_MEASURE to get the Jacobian determinant values for integration
+        // NEED_GRAD_TRANSFORM to get the Jacobian matrix to transform gradient from the parametric to physical domain
+        md.flags = NEED_MEASURE | (needGrads ? NEED_GRAD_TRANSFORM : 0);
+        geo.computeMap(md);
+        // find local indices of the pressure basis functions active on the element
+        basisRefs.back().active_into(quNodes.col(0),localIndicesPres);
+        N_P = localIndicesPres.rows();
+        // evaluate pressure basis functions and their derivatives on the element
+        basisRefs.back().evalAllDers_into(quNodes,needGrads ? 1 : 0,basisValuesPres);
+        // evaluate the convecting velocity
+        if (convDiff && velocity)
+            velocity->patch(patch).eval_into(quNodes,velocityValues);
+    }
+
+    inline void assemble(gsDomainIterator<T> & element,
+                         const gsVector<T> & quWeights)
+    {
+        localMass = basisValuesPres[0] * quWeights.asDiagonal() * md.measures.asDiagonal() * basisValuesPres[0].transpose();
+        if (!needGrads)
+            return;
+        localLaplacian.setZero(N_P,N_P);
+        localConvection.setZero(N_P,N_P);
+        for (index_t q = 0; q < quWeights.rows(); ++q)
+        {
+            const T weight = quWeights[q] * md.measure(q);
+            transformGradients(md, q, basisValuesPres[1], physGradPres);
+            localLaplacian.noalias() += weight * physGradPres.transpose() * physGradPres;
+            if (convDiff && velocity)
+                localConvection.noalias() += weight * basisValuesPres[0].col(q) *
+                                             (velocityValues.col(q).transpose() * physGradPres);
+        }
+    }
+
+    inline void localToGlobal(const int patchIndex,
+                              const std::vector<gsMatrix<T> > & eliminatedDofs,
+                              gsSparseSystem<T> & system)
+    {
+        // numbering of the pressure block, which is the last one
+        const gsDofMapper & mapper = system.colMapper(dim);
+        mapper.localToGlobal(localIndicesPres,patchIndex,globalIndices);
+        for (index_t i = 0; i < N_P; ++i)
+            if (mapper.is_free_index(globalIndices(i,0)))
+                for (index_t j = 0; j < N_P; ++j)
+                    if (mapper.is_free_index(globalIndices(j,0)))
+                    {
+                        mass->add(globalIndices(i,0),globalIndices(j,0),localMass(i,j));
+                        if (laplacian)
+                            laplacian->add(globalIndices(i,0),globalIndices(j,0),localLaplacian(i,j));
+                        if (convDiff)
+                            convDiff->add(globalIndices(i,0),globalIndices(j,0),
+                                          density*(viscosity*localLaplacian(i,j) + localConvection(i,j)));
+                    }
+    }
+
+protected:
+    // problem info
+    short_t dim;
+    index_t patch;
+    bool needGrads;
+    // output containers
+    gsSparseEntries<T> * mass;
+    gsSparseEntries<T> * laplacian;
+    gsSparseEntries<T> * convDiff;
+    // convecting velocity and material parameters
+    const gsMultiPatch<T> * velocity;
+    T viscosity, density;
+    // geometry mapping
+    gsMapData<T> md;
+    // local operators
+    gsMatrix<T> localMass, localLaplacian, localConvection;
+    // local indices (at the current patch) of the pressure basis functions active at the current element
+    gsMatrix<index_t> localIndicesPres;
+    // number of pressure basis functions active at the current element
+    index_t N_P;
+    // values and derivatives of pressure basis functions at quadrature points at the current element
+    std::vector<gsMatrix<T> > basisValuesPres;
+    // velocity values at quadrature points at the current element; stored as a dim x numQuadPoints matrix
+    gsMatrix<T> velocityValues;
+    // all temporary matrices defined here for efficiency
+    gsMatrix<T> physGradPres;
+    // container for global indices
+    gsMatrix<index_t> globalIndices;
+};
+
+} // namespace gismo
@@ -17,6 +17,7 @@
 #include <gsAssembler/gsQuadrature.h>
 #include <gsCore/gsFuncData.h>
 #include <gsElasticity/gsBasePde.h>
+#include <gsElasticity/gsVisitorElUtils.h>
 
 namespace gismo
 {
@@ -26,8 +27,9 @@ class gsVisitorStokes
 {
 public:
 
-    gsVisitorStokes(const gsPde<T> & pde_)
-        : pde_ptr(static_cast<const gsBasePde<T>*>(&pde_))
+    gsVisitorStokes(const gsPde<T> & pde_, gsSparseEntries<T> * elimEntries_ = nullptr)
+        : pde_ptr(static_cast<const gsBasePde<T>*>(&pde_)),
+          elimEntries(elimEntries_)
     {}
 
     void initialize(const gsBasisRefs<T> & basisRefs,
@@ -120,6 +122,14 @@ public:
         // push to global system
         system.pushToRhs(localRhs,globalIndices,blockNumbers);
         system.pushToMatrix(localMat,globalIndices,eliminatedDofs,blockNumbers,blockNumbers);
+        // push to the elimination system
+        if (elimEntries != nullptr)
+        {
+            localIndices.assign(dim,localIndicesVel);
+            localIndices.push_back(localIndicesPres);
+            pushToEliminationEntries(localMat,localIndices,globalIndices,blockNumbers,eliminatedDofs,
+                                     system,patchIndex,*elimEntries);
+        }
     }
 
 protected:
@@ -146,9 +156,13 @@ protected:
     // RHS values at quadrature points at the current element; stored as a dim x numQuadPoints matrix
     gsMatrix<T> forceValues;
 
+    // entries of the elimination matrix to efficiently change Dirichlet degrees of freedom
+    gsSparseEntries<T> * elimEntries;
+
     // all temporary matrices defined here for efficiency
     gsMatrix<T> block, physGradVel;
-    // containers for global indices
+    // containers for local (per block) and global indices
+    std::vector< gsMatrix<index_t> > localIndices;
     std::vector< gsMatrix<index_t> > globalIndices;
     gsVector<index_t> blockNumbers;
 };
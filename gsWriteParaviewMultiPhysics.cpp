@@ -0,0 +1,75 @@
+/** @file gsWriteParaviewMultiPhysics.cpp
+
+    @brief Non-template part of gsWriteParaviewMultiPhysics: encoding of the appended data blocks.
+    Compiled once, so that the optional zlib dependency only affects this translation unit.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+    Author(s): A. Shamanskiy (TU Kaiserslautern)
+*/
+
+#include <gsCore/gsDebug.h>
+#include <gsElasticity/gsWriteParaviewMultiPhysics.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#ifdef GS_ELASTICITY_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace gismo
+{
+
+std::string encodeVtkBlock(std::vector<char> const & raw, bool compress)
+{
+    std::string block;
+    const uint64_t rawSize = raw.size();
+    if (!compress)
+    {
+        block.append(reinterpret_cast<const char *>(&rawSize),sizeof(rawSize));
+        block.append(raw.begin(),raw.end());
+        return block;
+    }
+#ifdef GS_ELASTICITY_WITH_ZLIB
+    const uint64_t chunkSize = 32768;
+    const uint64_t numChunks = (rawSize + chunkSize - 1)/chunkSize;
+    // number of chunks, chunk size, size of the last partial chunk (0 if full), compressed size of each chunk
+    std::vector<uint64_t> header(3+numChunks);
+    header[0] = numChunks;
+    header[1] = chunkSize;
+    header[2] = rawSize % chunkSize;
+    std::string data;
+    std::vector<Bytef> chunk(compressBound(chunkSize));
+    for (uint64_t c = 0; c < numChunks; ++c)
+    {
+        const uint64_t size = std::min(chunkSize,rawSize - c*chunkSize);
+        uLongf compSize = chunk.size();
+        const int status = compress2(chunk.data(),&compSize,reinterpret_cast<const Bytef *>(raw.data() + c*chunkSize),
+                                     static_cast<uLong>(size),Z_BEST_SPEED);
+        GISMO_ENSURE(status == Z_OK, "zlib compression of Paraview output failed");
+        header[3+c] = compSize;
+        data.append(reinterpret_cast<const char *>(chunk.data()),compSize);
+    }
+    block.append(reinterpret_cast<const char *>(header.data()),header.size()*sizeof(uint64_t));
+    block += data;
+#else
+    GISMO_ERROR("gsElasticity is compiled without zlib");
+#endif
+    return block;
+}
+
+bool vtkCompressionAvailable()
+{
+#ifdef GS_ELASTICITY_WITH_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace gismo
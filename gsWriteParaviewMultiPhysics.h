@@ -17,6 +17,7 @@
 
 #include <gsCore/gsForwardDeclarations.h>
 #include <gsIO/gsParaviewCollection.h>
+#include <gsElasticity/gsBaseUtils.h>
 
 #define NS 1000
 
@@ -28,19 +29,26 @@ namespace gismo
 /// \param fn filename where paraview file is written
 /// \param npts number of points used for sampling each patch
 /// \param mesh if true, the parameter mesh is plotted as well
+/// \param format storage of the data arrays, see paraview_format
+/// \param precision floating point type of the data arrays, see paraview_precision
 template<class T>
 void gsWriteParaviewMultiPhysics(std::map<std::string, const gsField<T> *> fields, std::string const & fn,
-                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false);
+                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false,
+                     paraview_format::format format = paraview_format::ascii,
+                     paraview_precision::precision precision = paraview_precision::float32);
 
 /// \brief Write a file containing several fields defined on the same geometry to ONE paraview file
 /// and adds it as a timestep to a Paraview collection
 /// \param fields a map of field pointers
 /// \param fn filename where paraview file is written
 /// \param npts number of points used for sampling each patch
-/// \param mesh if true, the parameter mesh is plotted as well
+/// \param format storage of the data arrays, see paraview_format
+/// \param precision floating point type of the data arrays, see paraview_precision
 template<class T>
 void gsWriteParaviewMultiPhysicsTimeStep(std::map<std::string, const gsField<T> *> fields, std::string const & fn,
-                                         gsParaviewCollection & collection, int time, unsigned npts=NS);
+                                         gsParaviewCollection & collection, int time, unsigned npts=NS,
+                                         paraview_format::format format = paraview_format::ascii,
+                                         paraview_precision::precision precision = paraview_precision::float32);
 
 
 /// \brief Extract and evaluate geometry and the fields for a single patch
@@ -49,11 +57,15 @@ void gsWriteParaviewMultiPhysicsTimeStep(std::map<std::string, const gsField<T>
 /// \param patchNum a number of patch
 /// \param fn filename where paraview file is written
 /// \param npts number of points used for sampling each patch
+/// \param format storage of the data arrays, see paraview_format
+/// \param precision floating point type of the data arrays, see paraview_precision
 template<class T>
 void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string, const gsField<T> *> fields,
                                 const unsigned patchNum,
                                 std::string const & fn,
-                                unsigned npts);
+                                unsigned npts,
+                                paraview_format::format format = paraview_format::ascii,
+                                paraview_precision::precision precision = paraview_precision::float32);
 
 
 /// \brief Utility function to actually write prepaired matrices with data into Paraview file
@@ -62,11 +74,23 @@ void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string, const gsField<
 /// \param data a map of matrices with field evaluations to plotfilename where paraview file is written
 /// \param np a vector containg the data range info
 /// \param fn filename where paraview file is written
+/// \param format storage of the data arrays, see paraview_format
+/// \param precision floating point type of the data arrays, see paraview_precision
 template<class T>
 void gsWriteParaviewMultiTPgrid(gsMatrix<T> const& points,
                                 std::map<std::string, gsMatrix<T> >& data,
                                 const gsVector<index_t> & np,
-                                std::string const & fn);
+                                std::string const & fn,
+                                paraview_format::format format = paraview_format::ascii,
+                                paraview_precision::precision precision = paraview_precision::float32);
+
+/// \brief Encodes a byte buffer as a block of the appended data section of a VTK XML file with header_type="UInt64":
+/// either the byte count followed by the raw data, or the header of vtkZLibDataCompressor followed by
+/// the data compressed in chunks of 32 KiB
+GISMO_EXPORT std::string encodeVtkBlock(std::vector<char> const & raw, bool compress);
+
+/// \brief Returns true if gsElasticity is compiled with zlib, i.e. paraview_format::compressed is available
+GISMO_EXPORT bool vtkCompressionAvailable();
 
 }
 
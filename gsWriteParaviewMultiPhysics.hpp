@@ -20,6 +20,8 @@
 #include <gsIO/gsWriteParaview.h>
 #include <gsElasticity/gsGeoUtils.h>
 
+#include <cstdint>
+
 
 #define PLOT_PRECISION 11
 
@@ -75,7 +77,8 @@ void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
 template<class T>
 void gsWriteParaviewMultiPhysics(std::map<std::string, const gsField<T>*> fields,
                                  std::string const & fn,
-                                 unsigned npts, bool mesh, bool ctrlNet)
+                                 unsigned npts, bool mesh, bool ctrlNet,
+                                 paraview_format::format format, paraview_precision::precision precision)
 {
     const unsigned numP = fields.begin()->second->patches().nPatches();
     gsParaviewCollection collection(fn);
@@ -86,7 +89,7 @@ void gsWriteParaviewMultiPhysics(std::map<std::string, const gsField<T>*> fields
         const gsBasis<> & dom = fields.begin()->second->isParametrized() ?
             fields.begin()->second->igaFunction(i).basis() : fields.begin()->second->patch(i).basis();
 
-        gsWriteParaviewMultiPhysicsSinglePatch( fields, i, fn + util::to_string(i), npts);
+        gsWriteParaviewMultiPhysicsSinglePatch( fields, i, fn + util::to_string(i), npts, format, precision);
         collection.addPart(fileName + util::to_string(i), ".vts");
 
         if ( mesh )
@@ -106,14 +109,15 @@ void gsWriteParaviewMultiPhysics(std::map<std::string, const gsField<T>*> fields
 
 template<class T>
 void gsWriteParaviewMultiPhysicsTimeStep(std::map<std::string, const gsField<T> *> fields, std::string const & fn,
-                                         gsParaviewCollection & collection, int time, unsigned npts)
+                                         gsParaviewCollection & collection, int time, unsigned npts,
+                                         paraview_format::format format, paraview_precision::precision precision)
 {
     const unsigned numP = fields.begin()->second->patches().nPatches();
     std::string fileName = fn.substr(fn.find_last_of("/\\")+1); // file name without a path
 
     for ( size_t p = 0; p < numP; ++p)
     {
-        gsWriteParaviewMultiPhysicsSinglePatch(fields,p,fn + util::to_string(time) + "_" + util::to_string(p),npts);
+        gsWriteParaviewMultiPhysicsSinglePatch(fields,p,fn + util::to_string(time) + "_" + util::to_string(p),npts,format,precision);
         collection.addTimestep(fileName + util::to_string(time) + "_",p,time,".vts");
     }
 
@@ -123,7 +127,9 @@ template<class T>
 void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string,const gsField<T> *> fields,
                                 const unsigned patchNum,
                                 std::string const & fn,
-                                unsigned npts)
+                                unsigned npts,
+                                paraview_format::format format,
+                                paraview_precision::precision precision)
 {
     const gsGeometry<> & geometry = fields.begin()->second->patches().patch(patchNum);
     const short_t n = geometry.targetDim();
@@ -179,63 +185,119 @@ void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string,const gsField<T
         }
     }*/
 
-    gsWriteParaviewMultiTPgrid(eval_geo, data, np.template cast<index_t>(), fn);
+    gsWriteParaviewMultiTPgrid(eval_geo, data, np.template cast<index_t>(), fn, format, precision);
+}
+
+//---------- binary output
+
+/// true if the machine stores multi-byte numbers with the least significant byte first
+inline bool vtkLittleEndian()
+{
+    const uint16_t one = 1;
+    return *reinterpret_cast<const char *>(&one) == 1;
+}
+
+/// appends the columns of a matrix to a byte buffer as *numComp*-component tuples of type F;
+/// missing components are filled with zeros
+template<class F, class T>
+void appendVtkArray(gsMatrix<T> const & values, index_t numComp, std::vector<char> & buffer)
+{
+    const index_t rows = std::min<index_t>(values.rows(),numComp);
+    std::vector<F> array(values.cols()*numComp,F(0));
+    for (index_t j = 0; j < values.cols(); ++j)
+        for (index_t i = 0; i < rows; ++i)
+            array[j*numComp+i] = static_cast<F>(values(i,j));
+    const char * bytes = reinterpret_cast<const char *>(array.data());
+    buffer.insert(buffer.end(),bytes,bytes+array.size()*sizeof(F));
+}
+
+/// writes a DataArray element of a VTK XML file: either inline as text or as a reference to
+/// the block of the appended data section which is added to *appendedData*
+template<class T>
+void writeVtkDataArray(std::ofstream & file, gsMatrix<T> const & values, index_t numComp, std::string const & name,
+                       paraview_format::format format, paraview_precision::precision precision,
+                       std::string & appendedData)
+{
+    file <<"<DataArray type=\""<< (precision == paraview_precision::float64 ? "Float64" : "Float32") <<"\"";
+    if (!name.empty())
+        file <<" Name=\""<< name <<"\"";
+
+    if (format == paraview_format::ascii)
+    {
+        file <<" format=\"ascii\" NumberOfComponents=\""<< numComp <<"\">\n";
+        const index_t rows = std::min<index_t>(values.rows(),numComp);
+        for ( index_t j=0; j<values.cols(); ++j)
+        {
+            for ( index_t i=0; i!=rows; ++i)
+                file<< values(i,j) <<" ";
+            for ( index_t i=rows; i<numComp; ++i)
+                file<<"0 ";
+        }
+        file <<"</DataArray>\n";
+        return;
+    }
+
+    file <<" format=\"appended\" offset=\""<< appendedData.size() <<"\" NumberOfComponents=\""<< numComp <<"\"/>\n";
+    std::vector<char> raw;
+    if (precision == paraview_precision::float64)
+        appendVtkArray<double>(values,numComp,raw);
+    else
+        appendVtkArray<float>(values,numComp,raw);
+    appendedData += encodeVtkBlock(raw,format == paraview_format::compressed);
 }
 
 template<class T>
 void gsWriteParaviewMultiTPgrid(gsMatrix<T> const& points,
                                 std::map<std::string, gsMatrix<T> >& data,
                                 const gsVector<index_t> & np,
-                                std::string const & fn)
+                                std::string const & fn,
+                                paraview_format::format format,
+                                paraview_precision::precision precision)
 {
-    const int n = points.rows();
+    if (format == paraview_format::compressed && !vtkCompressionAvailable())
+    {
+        static bool warned = false;
+        if (!warned)
+            gsWarn << "gsElasticity is compiled without zlib; Paraview output is written uncompressed.\n";
+        warned = true;
+        format = paraview_format::binary;
+    }
+    const bool appended = format != paraview_format::ascii;
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), appended ? std::ios::out | std::ios::binary : std::ios::out);
     file << std::fixed; // no exponents
-    file << std::setprecision (PLOT_PRECISION);
+    file << std::setprecision (precision == paraview_precision::float64 ? 17 : PLOT_PRECISION);
 
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    if (appended)
+        file <<"<VTKFile type=\"StructuredGrid\" version=\"1.0\" byte_order=\""
+             << (vtkLittleEndian() ? "LittleEndian" : "BigEndian") <<"\" header_type=\"UInt64\""
+             << (format == paraview_format::compressed ? " compressor=\"vtkZLibDataCompressor\"" : "") <<">\n";
+    else
+        file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "
          << (np.size()>2 ? np(2)-1 : 0) <<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "
          << (np.size()>2 ? np(2)-1 : 0) <<"\">\n";
 
+    std::string appendedData;
     file <<"<PointData>\n";
     for (typename std::map<std::string, gsMatrix<T> >::iterator it = data.begin(); it != data.end(); it++)
-    {
-        file <<"<DataArray type=\"Float32\" Name=\""<< it->first <<"\" format=\"ascii\" NumberOfComponents=\""<< ( it->second.rows()==1 ? 1 : 3) <<"\">\n";
-        if ( it->second.rows()==1 )
-            for ( index_t j=0; j<it->second.cols(); ++j)
-                file<< it->second.at(j) <<" ";
-        else
-        {
-            for ( index_t j=0; j<it->second.cols(); ++j)
-            {
-                for ( index_t i=0; i!=it->second.rows(); ++i)
-                    file<< it->second(i,j) <<" ";
-                for ( index_t i=it->second.rows(); i<3; ++i)
-                    file<<"0 ";
-            }
-        }
-        file <<"</DataArray>\n";
-    }
+        writeVtkDataArray(file,it->second,it->second.rows()==1 ? 1 : 3,it->first,format,precision,appendedData);
     file <<"</PointData>\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\">\n";
-    for ( index_t j=0; j<points.cols(); ++j)
-    {
-        for ( index_t i=0; i!=n; ++i)
-            file<< points(i,j) <<" ";
-        for ( index_t i=n; i<3; ++i)
-            file<<"0 ";
-    }
-    file <<"</DataArray>\n";
+    writeVtkDataArray(file,points,3,"",format,precision,appendedData);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    if (appended)
+    {
+        file <<"<AppendedData encoding=\"raw\">\n_";
+        file.write(appendedData.data(),appendedData.size());
+        file <<"\n</AppendedData>\n";
+    }
     file <<"</VTKFile>\n";
 
     file.close();
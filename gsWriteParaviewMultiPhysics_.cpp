@@ -8,21 +8,27 @@ namespace gismo
 {
 TEMPLATE_INST
 void gsWriteParaviewMultiPhysics(std::map<std::string, const gsField<real_t>* > fields, std::string const & fn,
-                     unsigned npts, bool mesh, bool cnet);
+                     unsigned npts, bool mesh, bool cnet,
+                     paraview_format::format format, paraview_precision::precision precision);
 
 TEMPLATE_INST
 void gsWriteParaviewMultiPhysicsTimeStep(std::map<std::string, const gsField<real_t> *> fields, std::string const & fn,
-                                         gsParaviewCollection & collection, int time, unsigned npts);
+                                         gsParaviewCollection & collection, int time, unsigned npts,
+                                         paraview_format::format format, paraview_precision::precision precision);
 
 TEMPLATE_INST
 void gsWriteParaviewMultiPhysicsSinglePatch(std::map<std::string,const gsField<real_t>* > fields,
                                 const unsigned patchNum,
                                 std::string const & fn,
-                                unsigned npts);
+                                unsigned npts,
+                                paraview_format::format format,
+                                paraview_precision::precision precision);
 
 TEMPLATE_INST
 void gsWriteParaviewMultiTPgrid(gsMatrix<real_t> const& points,
                                 std::map<std::string, gsMatrix<real_t> >& data,
                                 const gsVector<index_t> & np,
-                                std::string const & fn);
+                                std::string const & fn,
+                                paraview_format::format format,
+                                paraview_precision::precision precision);
 }